@@ -0,0 +1,24 @@
+# SPDX-License-Identifier: Unlicense
+
+string( TOUPPER ${PROJECT_NAME} PROJECT_NAME_UPPERCASE )
+
+if ( NOT MSVC )
+    option( ${PROJECT_NAME_UPPERCASE}_SANITIZE_THREAD "Build with ThreadSanitizer (for checking the loader and benchmark_completion_queue)" OFF )
+endif()
+
+# Godot itself is not instrumented, so the runtime has to be preloaded when running it:
+#   LD_PRELOAD=$(${CMAKE_CXX_COMPILER} -print-file-name=libtsan.so) godot ...
+if ( NOT MSVC AND ${PROJECT_NAME_UPPERCASE}_SANITIZE_THREAD )
+    message( STATUS "[${PROJECT_NAME}] Building with ThreadSanitizer")
+
+    target_compile_options( ${PROJECT_NAME}
+        PRIVATE
+            -fsanitize=thread
+            -fno-omit-frame-pointer
+    )
+
+    target_link_options( ${PROJECT_NAME}
+        PRIVATE
+            -fsanitize=thread
+    )
+endif()
@@ -1,18 +1,60 @@
 
+#include <godot_cpp/classes/json.hpp>
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/core/object.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
 #include "Core.hpp"
+#include "LevelResourceLoader.hpp"
+#include "ModelMesh.hpp"
 #include "Version.h"
 
+#include "SWBF2/Benchmarks.hpp"
 #include "SWBF2/Chunks/ChunkProcessor.hpp"
+#include "SWBF2/Chunks/ChunkProfiler.hpp"
+#include "SWBF2/Chunks/Hashing.hpp"
+#include "SWBF2/Chunks/LoadProfile.hpp"
+#include "SWBF2/EntityClasses.hpp"
+#include "SWBF2/LevelLoader.hpp"
+#include "SWBF2/Logging.hpp"
+#include "SWBF2/MemoryAccounting.hpp"
 #include "SWBF2/Models.hpp"
+#include "SWBF2/Threading/CompletionQueue.hpp"
+#include "SWBF2/Threading/Executor.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <thread>
 
 namespace SWBF2
 {
+    namespace
+    {
+        bool IsValidRetention(int64_t retention)
+        {
+            if (retention >= static_cast<int64_t>(ModelRetention::KeepAll) && retention <= static_cast<int64_t>(ModelRetention::KeepCollision))
+            {
+                return true;
+            }
+
+            godot::UtilityFunctions::printerr(__FILE__, ":", __LINE__, ": invalid model retention ", retention);
+            return false;
+        }
+
+        bool IsValidLogLevel(int64_t level)
+        {
+            if (level >= static_cast<int64_t>(LogLevel::Verbose) && level <= static_cast<int64_t>(LogLevel::Error))
+            {
+                return true;
+            }
+
+            godot::UtilityFunctions::printerr(__FILE__, ":", __LINE__, ": invalid log level ", level);
+            return false;
+        }
+    }
+
     Core::Core()
     {
     }
@@ -24,14 +66,818 @@ namespace SWBF2
 
         godot::UtilityFunctions::print("hello world!");
 
+        SetUseWorkerThreadPool(m_useWorkerThreadPool);
+
+        Models::SetInsertObserver([id = get_instance_id()](const std::string &name)
+            {
+                // still on the loading thread, so model_loaded comes after the mesh exists
+                ModelMesh::OnModelInserted(name);
+
+                QueueOnMainThread(id, [name](Core &core) { core.emit_signal("model_loaded", godot::String{ name.c_str() }); });
+            });
+        Models::SetRemoveObserver(ModelMesh::OnModelRemoved);
+
         // UcfbChunk::ReadUcfbFile("data/_lvl_pc/common.lvl");
         // UcfbChunk::ReadUcfbFile("data/_lvl_pc/core.lvl");
         UcfbChunk::ReadUcfbFile("data/_lvl_pc/cor/cor1.lvl");
 
-        Models::m_models;
+        auto *performance = godot::Performance::get_singleton();
+        m_monitors.push_back("SWBF2/Total bytes");
+        performance->add_custom_monitor(m_monitors.back(), godot::Callable(this, "get_total_memory_bytes"));
+        m_monitors.push_back("SWBF2/Model bytes");
+        performance->add_custom_monitor(m_monitors.back(), godot::Callable(this, "get_model_memory_bytes"));
+        m_monitors.push_back("SWBF2/Completion queue depth");
+        performance->add_custom_monitor(m_monitors.back(), godot::Callable(this, "get_completion_queue_depth"));
+        m_monitors.push_back("SWBF2/Completion drain msec");
+        performance->add_custom_monitor(m_monitors.back(), godot::Callable(this, "get_completion_drain_msec"));
+    }
+
+    void Core::_process(double delta)
+    {
+        CompletionQueue::GetMain().Drain(std::chrono::microseconds{ m_completionBudgetUsec });
+    }
+
+    void Core::_exit_tree()
+    {
+        Models::SetInsertObserver({});
+        Models::SetRemoveObserver({});
+
+        auto *performance = godot::Performance::get_singleton();
+        for (const auto &monitor : m_monitors)
+        {
+            if (performance->has_custom_monitor(monitor))
+            {
+                performance->remove_custom_monitor(monitor);
+            }
+        }
+
+        m_monitors.clear();
+
+        MemoryAccounting::RemoveLevelMonitors();
+    }
+
+    godot::Dictionary Core::GetModelCacheStats() const
+    {
+        const auto stats = Models::GetStats();
+
+        godot::Dictionary result;
+        result["hits"] = static_cast<int64_t>(stats.m_hits);
+        result["misses"] = static_cast<int64_t>(stats.m_misses);
+        result["evictions"] = static_cast<int64_t>(stats.m_evictions);
+        result["resident_bytes"] = static_cast<int64_t>(stats.m_residentBytes);
+        result["budget_bytes"] = static_cast<int64_t>(stats.m_budgetBytes);
+        result["model_count"] = static_cast<int64_t>(stats.m_modelCount);
+        result["resident_count"] = static_cast<int64_t>(stats.m_residentCount);
+        return result;
+    }
+
+    void Core::SetModelMemoryBudget(int64_t bytes)
+    {
+        Models::SetMemoryBudget(bytes > 0 ? static_cast<std::size_t>(bytes) : 0);
+    }
+
+    void Core::SetModelRetention(const godot::String &name, int64_t retention)
+    {
+        if (!IsValidRetention(retention))
+        {
+            return;
+        }
+
+        Models::SetRetention(name.utf8().get_data(), static_cast<ModelRetention>(retention));
+    }
+
+    void Core::SetDefaultModelRetention(int64_t retention)
+    {
+        if (!IsValidRetention(retention))
+        {
+            return;
+        }
+
+        Models::SetDefaultRetention(static_cast<ModelRetention>(retention));
+    }
+
+    godot::Ref<godot::ArrayMesh> Core::GetModelMesh(const godot::String &name)
+    {
+        return ModelMesh::Upload(name.utf8().get_data());
+    }
+
+    void Core::SetCreateMeshesOnLoad(bool create)
+    {
+        ModelMesh::SetCreateOnLoad(create);
+    }
+
+    bool Core::IsCreatingMeshesOnLoad() const
+    {
+        return ModelMesh::IsCreatingOnLoad();
+    }
+
+    godot::RID Core::GetModelMeshRid(const godot::String &name) const
+    {
+        return ModelMesh::GetMesh(name.utf8().get_data());
+    }
+
+    void Core::SetUseWorkerThreadPool(bool use)
+    {
+        // the executor can't be replaced under tasks it still has to run
+        if (IsLoading())
+        {
+            godot::UtilityFunctions::printerr(__FILE__, ":", __LINE__, ": can't change the thread pool while levels are loading");
+            return;
+        }
+
+        m_useWorkerThreadPool = use;
+
+        const auto backend = use ? ExecutorBackend::WorkerThreadPool : ExecutorBackend::ThreadPool;
+        if (Executor::GetDefault().GetBackend() != backend)
+        {
+            Executor::SetDefault(backend);
+        }
+    }
+
+    bool Core::IsUsingWorkerThreadPool() const
+    {
+        return m_useWorkerThreadPool;
+    }
+
+    void Core::SetLazyModelDecoding(bool lazy)
+    {
+        Models::SetDecodeMode(lazy ? ModelDecodeMode::Lazy : ModelDecodeMode::Eager);
+    }
+
+    bool Core::IsLazyModelDecoding() const
+    {
+        return Models::GetDecodeMode() == ModelDecodeMode::Lazy;
+    }
+
+    godot::Dictionary Core::GetMemoryUsage() const
+    {
+        auto streamsToDictionary = [](const StreamMemoryUsage &streams)
+            {
+                godot::Dictionary result;
+                for (std::size_t i = 0; i < streams.size(); ++i)
+                {
+                    result[MemoryAccounting::GetStreamName(static_cast<AttributeStream>(i))] = static_cast<int64_t>(streams[i]);
+                }
+                return result;
+            };
+
+        godot::Dictionary levels;
+        for (const auto &usage : MemoryAccounting::GetLevelUsage())
+        {
+            godot::Dictionary level;
+            level["buffer_bytes"] = static_cast<int64_t>(usage.m_bufferBytes);
+            level["model_bytes"] = static_cast<int64_t>(usage.m_modelBytes);
+            level["model_count"] = static_cast<int64_t>(usage.m_modelCount);
+            level["budget_bytes"] = static_cast<int64_t>(usage.m_budgetBytes);
+            level["streams"] = streamsToDictionary(usage.m_streams);
+            levels[usage.m_level.c_str()] = level;
+        }
+
+        godot::Dictionary models;
+        for (const auto &usage : MemoryAccounting::GetModelUsage())
+        {
+            godot::Dictionary model;
+            model["level"] = usage.m_level.c_str();
+            model["resident"] = usage.m_resident;
+            model["bytes"] = static_cast<int64_t>(usage.m_bytes);
+            model["streams"] = streamsToDictionary(usage.m_streams);
+            models[usage.m_name.c_str()] = model;
+        }
+
+        godot::Dictionary result;
+        result["total_bytes"] = GetTotalMemoryBytes();
+        result["levels"] = levels;
+        result["models"] = models;
+        return result;
+    }
+
+    void Core::SetLevelMemoryBudget(const godot::String &level, int64_t bytes)
+    {
+        MemoryAccounting::SetLevelBudget(level.utf8().get_data(), bytes > 0 ? static_cast<std::size_t>(bytes) : 0);
+    }
+
+    int64_t Core::GetTotalMemoryBytes() const
+    {
+        return static_cast<int64_t>(MemoryAccounting::GetTotalBytes());
+    }
+
+    int64_t Core::GetModelMemoryBytes() const
+    {
+        return static_cast<int64_t>(Models::GetStats().m_residentBytes);
+    }
+
+    int64_t Core::GetLevelMemoryBytes(const godot::String &level) const
+    {
+        auto usage = MemoryAccounting::GetLevelUsage(level.utf8().get_data());
+        return usage ? static_cast<int64_t>(usage->m_bufferBytes + usage->m_modelBytes) : 0;
+    }
+
+    godot::Dictionary Core::BenchmarkLevelLoad(const godot::String &filename, int64_t maxThreads, int64_t repeats)
+    {
+        godot::Dictionary result;
+        for (const auto &scaling : Benchmarks::LevelLoadScaling(filename.utf8().get_data(), std::max<int64_t>(maxThreads, 0), std::max<int64_t>(repeats, 1)))
+        {
+            godot::Dictionary entry;
+            entry["msec"] = scaling.m_milliseconds;
+            entry["speedup"] = scaling.m_speedup;
+            result[static_cast<int64_t>(scaling.m_threadCount)] = entry;
+        }
+
+        return result;
+    }
+
+    godot::Dictionary Core::BenchmarkHashing(const godot::PackedStringArray &names, int64_t repeats)
+    {
+        std::vector<std::string> parsed;
+        parsed.reserve(names.size());
+
+        for (const auto &name : names)
+        {
+            parsed.push_back(name.utf8().get_data());
+        }
+
+        const auto throughput = Benchmarks::HashThroughput(parsed, std::max<int64_t>(repeats, 1));
+
+        godot::Dictionary result;
+        result["scalar_names_per_sec"] = throughput.m_scalarNamesPerSecond;
+        result["batch_names_per_sec"] = throughput.m_batchNamesPerSecond;
+        result["speedup"] = throughput.m_batchNamesPerSecond / throughput.m_scalarNamesPerSecond;
+        result["identical"] = throughput.m_identical;
+
+        return result;
+    }
+
+    godot::Dictionary Core::BenchmarkMeshBuild(const godot::PackedStringArray &names, int64_t repeats)
+    {
+        std::vector<std::string> parsed;
+        for (int64_t i = 0; i < names.size(); ++i)
+        {
+            parsed.push_back(names[i].utf8().get_data());
+        }
+
+        // every cached model when no names are given
+        if (parsed.empty())
+        {
+            for (const auto &usage : Models::GetMemoryUsage())
+            {
+                parsed.push_back(usage.m_name);
+            }
+        }
+
+        auto benchmark = ModelMesh::BenchmarkBuild(parsed, std::max<int64_t>(repeats, 1));
+
+        godot::Dictionary result;
+        result["segments"] = static_cast<int64_t>(benchmark.m_segments);
+        result["node_msec_per_1000"] = benchmark.m_nodeMillisecondsPer1000;
+        result["server_msec_per_1000"] = benchmark.m_serverMillisecondsPer1000;
+        result["server_wall_msec_per_1000"] = benchmark.m_serverWallMillisecondsPer1000;
+        return result;
+    }
+
+    godot::Dictionary Core::BenchmarkLoadProfiles(const godot::PackedStringArray &filenames, const godot::String &baseline, const godot::String &candidate, int64_t repeats)
+    {
+        const auto names = LoadProfiles::GetNames();
+        for (const auto &name : { baseline, candidate })
+        {
+            if (std::ranges::find(names, std::string(name.utf8().get_data())) == names.end())
+            {
+                godot::UtilityFunctions::printerr(__FILE__, ":", __LINE__, ": unknown load profile ", name);
+                return {};
+            }
+        }
+
+        std::vector<std::string> files;
+        files.reserve(filenames.size());
+
+        for (const auto &filename : filenames)
+        {
+            files.push_back(filename.utf8().get_data());
+        }
+
+        const auto results = Benchmarks::CompareLoadProfiles(files, { baseline.utf8().get_data(), candidate.utf8().get_data() }, std::max<int64_t>(repeats, 1));
+        if (results.size() != 2)
+        {
+            return {};
+        }
+
+        godot::Dictionary result;
+        for (const auto &[key, profile] : { std::pair{ "baseline", &results[0] }, std::pair{ "candidate", &results[1] } })
+        {
+            godot::Dictionary entry;
+            entry["profile"] = profile->m_profile.c_str();
+            entry["msec"] = profile->m_milliseconds;
+            entry["model_bytes"] = static_cast<int64_t>(profile->m_modelBytes);
+            entry["total_bytes"] = static_cast<int64_t>(profile->m_totalBytes);
+            result[key] = entry;
+        }
+
+        result["msec_saved"] = results[0].m_milliseconds - results[1].m_milliseconds;
+        result["model_bytes_saved"] = static_cast<int64_t>(results[0].m_modelBytes) - static_cast<int64_t>(results[1].m_modelBytes);
+        result["total_bytes_saved"] = static_cast<int64_t>(results[0].m_totalBytes) - static_cast<int64_t>(results[1].m_totalBytes);
+
+        return result;
+    }
+
+    godot::Dictionary Core::BenchmarkLoadGraph(int64_t nodes, int64_t repeats)
+    {
+        const auto graph = Benchmarks::LoadGraphOrdering(std::max<int64_t>(nodes, 0), std::max<int64_t>(repeats, 1));
+
+        godot::Dictionary result;
+        result["nodes"] = static_cast<int64_t>(graph.m_nodes);
+        result["msec"] = graph.m_milliseconds;
+        result["ordered"] = graph.m_ordered;
+
+        return result;
+    }
+
+    godot::Dictionary Core::BenchmarkCompletionQueue(int64_t producers, int64_t tasksPerProducer, int64_t budgetUsec)
+    {
+        const auto stress = Benchmarks::CompletionQueueStress(std::max<int64_t>(producers, 1), std::max<int64_t>(tasksPerProducer, 0), std::chrono::microseconds{ std::max<int64_t>(budgetUsec, 0) });
+
+        godot::Dictionary result;
+        result["tasks"] = static_cast<int64_t>(stress.m_tasks);
+        result["ran"] = static_cast<int64_t>(stress.m_ran);
+        result["msec"] = stress.m_milliseconds;
+        result["ordered"] = stress.m_ordered;
+
+        return result;
+    }
+
+    int64_t Core::LoadLevel(const godot::String &filename, int64_t priority)
+    {
+        if (priority < 0 || priority >= static_cast<int64_t>(TaskPriority::Count))
+        {
+            godot::UtilityFunctions::printerr(__FILE__, ":", __LINE__, ": invalid load priority ", priority);
+            return 0;
+        }
+
+        const auto id = m_nextLoadId++;
+        m_loads[id] = LevelLoader::Load(filename.utf8().get_data(), static_cast<TaskPriority>(priority), [coreId = get_instance_id(), id](LoadStatus status)
+            {
+                QueueOnMainThread(coreId, [id, status](Core &core)
+                    {
+                        core.emit_signal("load_finished", id, static_cast<int64_t>(status));
+                        core.m_loads.erase(id);
+                    });
+            });
+        return id;
+    }
+
+    int64_t Core::LoadLevels(const godot::PackedStringArray &filenames, int64_t priority)
+    {
+        if (priority < 0 || priority >= static_cast<int64_t>(TaskPriority::Count))
+        {
+            godot::UtilityFunctions::printerr(__FILE__, ":", __LINE__, ": invalid load priority ", priority);
+            return 0;
+        }
+
+        std::vector<std::string> files;
+        files.reserve(filenames.size());
+
+        for (const auto &filename : filenames)
+        {
+            files.push_back(filename.utf8().get_data());
+        }
+
+        const auto id = m_nextLoadId++;
+        m_batches[id] = LevelLoader::LoadAll(files, static_cast<TaskPriority>(priority), [coreId = get_instance_id(), id](LoadStatus status)
+            {
+                QueueOnMainThread(coreId, [id, status](Core &core)
+                    {
+                        core.emit_signal("load_finished", id, static_cast<int64_t>(status));
+                        core.m_batches.erase(id);
+                    });
+            });
+        return id;
+    }
+
+    void Core::CancelLoad(int64_t id)
+    {
+        if (auto it = m_loads.find(id); it != m_loads.end())
+        {
+            it->second->Cancel();
+        }
+
+        if (auto it = m_batches.find(id); it != m_batches.end())
+        {
+            it->second->Cancel();
+        }
+    }
+
+    void Core::CancelAllLoads()
+    {
+        LevelLoader::CancelAll();
+    }
+
+    int64_t Core::GetLoadStatus(int64_t id) const
+    {
+        if (auto it = m_loads.find(id); it != m_loads.end())
+        {
+            return static_cast<int64_t>(it->second->GetStatus());
+        }
+
+        if (auto it = m_batches.find(id); it != m_batches.end())
+        {
+            return static_cast<int64_t>(it->second->GetStatus());
+        }
+
+        return -1;
+    }
+
+    double Core::GetLoadProgress(int64_t id) const
+    {
+        if (auto it = m_loads.find(id); it != m_loads.end())
+        {
+            return it->second->GetProgress();
+        }
+
+        if (auto it = m_batches.find(id); it != m_batches.end())
+        {
+            const auto &requests = it->second->GetRequests();
+            if (requests.empty())
+            {
+                return 1.0;
+            }
+
+            double progress = 0.0;
+            for (const auto &request : requests)
+            {
+                progress += request->GetProgress();
+            }
+            return progress / requests.size();
+        }
+
+        return -1.0;
+    }
+
+    double Core::GetLevelLoadProgress(const godot::String &path) const
+    {
+        return LevelResourceLoader::GetProgress(path);
+    }
+
+    void Core::WaitForLoad(int64_t id)
+    {
+        if (auto it = m_loads.find(id); it != m_loads.end())
+        {
+            it->second->Wait();
+        }
+
+        if (auto it = m_batches.find(id); it != m_batches.end())
+        {
+            it->second->Wait();
+        }
+    }
+
+    godot::Dictionary Core::GetLoaderStats() const
+    {
+        const auto stats = LevelLoader::GetStats();
+
+        godot::Dictionary result;
+        result["requested"] = static_cast<int64_t>(stats.m_requested);
+        result["finished"] = static_cast<int64_t>(stats.m_finished);
+        result["cancelled"] = static_cast<int64_t>(stats.m_cancelled);
+        result["failed"] = static_cast<int64_t>(stats.m_failed);
+        result["cancel_latency_avg_msec"] = stats.m_cancelled ? stats.m_cancelLatencyTotalMilliseconds / stats.m_cancelled : 0.0;
+        result["cancel_latency_max_msec"] = stats.m_cancelLatencyMaxMilliseconds;
+        return result;
+    }
+
+    godot::Dictionary Core::GetBatchStats(int64_t id) const
+    {
+        godot::Dictionary result;
+
+        auto it = m_batches.find(id);
+        if (it == m_batches.end() || !it->second->IsDone())
+        {
+            return result;
+        }
+
+        const auto stats = it->second->GetStats();
+        result["total_msec"] = stats.m_totalMilliseconds;
+        result["critical_path_msec"] = stats.m_criticalPathMilliseconds;
+        result["plan_msec"] = stats.m_planMilliseconds;
+        result["serial_msec"] = stats.m_serialMilliseconds;
+        result["duplicate_models"] = static_cast<int64_t>(stats.m_duplicateModels);
+
+        godot::Dictionary files;
+        for (const auto &request : it->second->GetRequests())
+        {
+            files[request->GetFilename().c_str()] = request->GetMilliseconds();
+        }
+
+        result["files_msec"] = files;
+        return result;
+    }
+
+    void Core::SetCompletionBudgetUsec(int64_t usec)
+    {
+        m_completionBudgetUsec = std::max<int64_t>(usec, 0);
+    }
+
+    int64_t Core::GetCompletionBudgetUsec() const
+    {
+        return m_completionBudgetUsec;
+    }
+
+    godot::Dictionary Core::GetCompletionStats() const
+    {
+        const auto stats = CompletionQueue::GetMain().GetStats();
+
+        godot::Dictionary result;
+        result["depth"] = static_cast<int64_t>(stats.m_depth);
+        result["pushed"] = static_cast<int64_t>(stats.m_pushed);
+        result["drained"] = static_cast<int64_t>(stats.m_drained);
+        result["last_drain_count"] = static_cast<int64_t>(stats.m_lastDrainCount);
+        result["last_drain_msec"] = stats.m_lastDrainMilliseconds;
+        result["max_drain_msec"] = stats.m_maxDrainMilliseconds;
+        return result;
+    }
+
+    int64_t Core::GetCompletionQueueDepth() const
+    {
+        return static_cast<int64_t>(CompletionQueue::GetMain().GetDepth());
+    }
+
+    double Core::GetCompletionDrainMsec() const
+    {
+        return CompletionQueue::GetMain().GetStats().m_lastDrainMilliseconds;
+    }
+
+    void Core::SetLogLevel(int64_t level)
+    {
+        if (!IsValidLogLevel(level))
+        {
+            return;
+        }
+
+        Logging::SetLevel(static_cast<LogLevel>(level));
+    }
+
+    int64_t Core::GetLogLevel() const
+    {
+        return static_cast<int64_t>(Logging::GetLevel());
+    }
+
+    godot::Dictionary Core::GetLogStats() const
+    {
+        const auto stats = Logging::GetStats();
+
+        godot::Dictionary result;
+        result["written"] = static_cast<int64_t>(stats.m_written);
+        result["suppressed"] = static_cast<int64_t>(stats.m_suppressed);
+        result["chunks_counted"] = static_cast<int64_t>(stats.m_chunksCounted);
+        result["pending"] = static_cast<int64_t>(stats.m_pending);
+        return result;
+    }
+
+    void Core::SetChunkProfiling(bool enabled)
+    {
+        ChunkProfiler::SetEnabled(enabled);
+    }
+
+    bool Core::IsChunkProfiling() const
+    {
+        return ChunkProfiler::IsEnabled();
+    }
+
+    godot::Dictionary Core::GetChunkProfile() const
+    {
+        godot::Dictionary result;
+        for (const auto &profile : ChunkProfiler::GetProfiles())
+        {
+            const godot::String filename = profile.m_filename.c_str();
+            if (!result.has(filename))
+            {
+                result[filename] = godot::Dictionary();
+            }
+
+            godot::Dictionary stats;
+            stats["count"] = static_cast<int64_t>(profile.m_count);
+            stats["bytes"] = static_cast<int64_t>(profile.m_bytes);
+            stats["total_msec"] = profile.m_totalMilliseconds;
+            stats["p50_msec"] = profile.m_p50Milliseconds;
+            stats["p99_msec"] = profile.m_p99Milliseconds;
+            stats["max_msec"] = profile.m_maxMilliseconds;
+
+            ChunkHeader header;
+            header.m_Magic = profile.m_magic;
+
+            char name[ChunkHeader::FORMATTED_SIZE];
+            godot::Dictionary types = result[filename];
+            types[header.Format(name)] = stats;
+        }
+
+        return result;
+    }
+
+    godot::String Core::GetChunkProfileJson() const
+    {
+        return godot::JSON::stringify(GetChunkProfile(), "\t");
+    }
+
+    void Core::ResetChunkProfile()
+    {
+        ChunkProfiler::Reset();
+    }
+
+    bool Core::RegisterLoadProfile(const godot::String &name, const godot::PackedStringArray &skips)
+    {
+        std::vector<ChunkSkip> parsed;
+        for (int64_t i = 0; i < skips.size(); ++i)
+        {
+            auto skip = LoadProfiles::ParseSkip(skips[i].utf8().get_data());
+            if (!skip)
+            {
+                godot::UtilityFunctions::printerr(__FILE__, ":", __LINE__, ": invalid chunk skip ", skips[i], ", expected parent/child");
+                return false;
+            }
+
+            parsed.push_back(*skip);
+        }
+
+        LoadProfiles::Register(name.utf8().get_data(), parsed);
+        return true;
+    }
+
+    void Core::SetLoadProfile(const godot::String &name)
+    {
+        if (!LoadProfiles::SetActive(name.utf8().get_data()))
+        {
+            godot::UtilityFunctions::printerr(__FILE__, ":", __LINE__, ": unknown load profile ", name);
+        }
+    }
+
+    godot::String Core::GetLoadProfile() const
+    {
+        return LoadProfiles::GetActive().GetName().c_str();
+    }
+
+    godot::PackedStringArray Core::GetLoadProfiles() const
+    {
+        godot::PackedStringArray result;
+        for (const auto &name : LoadProfiles::GetNames())
+        {
+            result.push_back(name.c_str());
+        }
+
+        return result;
+    }
+
+    bool Core::OpenHashDictionary(const godot::String &filename)
+    {
+        return FNV::OpenLookupTable(filename.utf8().get_data());
+    }
+
+    bool Core::WriteHashDictionary(const godot::String &filename, const godot::PackedStringArray &names)
+    {
+        std::vector<std::string> parsed;
+        parsed.reserve(names.size());
+
+        for (const auto &name : names)
+        {
+            parsed.push_back(name.utf8().get_data());
+        }
+
+        return FNV::WriteLookupTable(filename.utf8().get_data(), parsed);
+    }
+
+    godot::String Core::LookupHash(int64_t hash) const
+    {
+        const auto name = FNV::Lookup(static_cast<FNVHash>(hash));
+        return name ? godot::String::utf8(name->data(), name->size()) : godot::String();
+    }
+
+    bool Core::HasEntityClass(const godot::String &name) const
+    {
+        return EntityClasses::Find(std::string_view{ name.utf8().get_data() }) != nullptr;
+    }
+
+    godot::String Core::GetClassProperty(const godot::String &name, const godot::String &property) const
+    {
+        const auto value = EntityClasses::CopyProperty(FNV::HashConstexpr(name.utf8().get_data()), FNV::HashConstexpr(property.utf8().get_data()));
+        return value ? godot::String::utf8(value->data(), value->size()) : godot::String();
+    }
+
+    void Core::SetClassProperty(const godot::String &name, const godot::String &property, const godot::String &value)
+    {
+        // loads may be reading classes on other threads meanwhile
+        if (!EntityClasses::SetProperty(FNV::HashConstexpr(name.utf8().get_data()), FNV::HashConstexpr(property.utf8().get_data()), value.utf8().get_data()))
+        {
+            godot::UtilityFunctions::printerr(__FILE__, ":", __LINE__, ": unknown entity class ", name);
+        }
+    }
+
+    int64_t Core::GetEntityClassCount() const
+    {
+        return static_cast<int64_t>(EntityClasses::GetCount());
+    }
+
+    void Core::QueueOnMainThread(uint64_t coreId, std::function<void(Core &core)> function)
+    {
+        CompletionQueue::GetMain().Push([coreId, function = std::move(function)]
+            {
+                if (auto *core = godot::Object::cast_to<Core>(godot::ObjectDB::get_instance(coreId)))
+                {
+                    function(*core);
+                }
+            });
+    }
+
+    bool Core::IsLoading() const
+    {
+        return std::ranges::any_of(m_loads, [](const auto &load) { return !load.second->IsDone(); })
+            || std::ranges::any_of(m_batches, [](const auto &batch) { return !batch.second->IsDone(); });
     }
 
     void Core::_bind_methods()
     {
+        godot::ClassDB::bind_method(godot::D_METHOD("get_model_cache_stats"), &Core::GetModelCacheStats);
+        godot::ClassDB::bind_method(godot::D_METHOD("set_model_memory_budget", "bytes"), &Core::SetModelMemoryBudget);
+        godot::ClassDB::bind_method(godot::D_METHOD("set_model_retention", "name", "retention"), &Core::SetModelRetention);
+        godot::ClassDB::bind_method(godot::D_METHOD("set_default_model_retention", "retention"), &Core::SetDefaultModelRetention);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_model_mesh", "name"), &Core::GetModelMesh);
+        godot::ClassDB::bind_method(godot::D_METHOD("set_create_meshes_on_load", "create"), &Core::SetCreateMeshesOnLoad);
+        godot::ClassDB::bind_method(godot::D_METHOD("is_creating_meshes_on_load"), &Core::IsCreatingMeshesOnLoad);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_model_mesh_rid", "name"), &Core::GetModelMeshRid);
+        godot::ClassDB::bind_method(godot::D_METHOD("set_use_worker_thread_pool", "use"), &Core::SetUseWorkerThreadPool);
+        godot::ClassDB::bind_method(godot::D_METHOD("is_using_worker_thread_pool"), &Core::IsUsingWorkerThreadPool);
+        godot::ClassDB::bind_method(godot::D_METHOD("set_lazy_model_decoding", "lazy"), &Core::SetLazyModelDecoding);
+        godot::ClassDB::bind_method(godot::D_METHOD("is_lazy_model_decoding"), &Core::IsLazyModelDecoding);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_memory_usage"), &Core::GetMemoryUsage);
+        godot::ClassDB::bind_method(godot::D_METHOD("set_level_memory_budget", "level", "bytes"), &Core::SetLevelMemoryBudget);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_total_memory_bytes"), &Core::GetTotalMemoryBytes);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_model_memory_bytes"), &Core::GetModelMemoryBytes);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_level_memory_bytes", "level"), &Core::GetLevelMemoryBytes);
+        godot::ClassDB::bind_method(godot::D_METHOD("benchmark_level_load", "filename", "max_threads", "repeats"), &Core::BenchmarkLevelLoad);
+        godot::ClassDB::bind_method(godot::D_METHOD("benchmark_hashing", "names", "repeats"), &Core::BenchmarkHashing);
+        godot::ClassDB::bind_method(godot::D_METHOD("benchmark_mesh_build", "names", "repeats"), &Core::BenchmarkMeshBuild);
+        godot::ClassDB::bind_method(godot::D_METHOD("benchmark_load_profiles", "filenames", "baseline", "candidate", "repeats"), &Core::BenchmarkLoadProfiles);
+        godot::ClassDB::bind_method(godot::D_METHOD("benchmark_load_graph", "nodes", "repeats"), &Core::BenchmarkLoadGraph);
+        godot::ClassDB::bind_method(godot::D_METHOD("benchmark_completion_queue", "producers", "tasks_per_producer", "budget_usec"), &Core::BenchmarkCompletionQueue);
+        godot::ClassDB::bind_method(godot::D_METHOD("load_level", "filename", "priority"), &Core::LoadLevel);
+        godot::ClassDB::bind_method(godot::D_METHOD("load_levels", "filenames", "priority"), &Core::LoadLevels);
+        godot::ClassDB::bind_method(godot::D_METHOD("cancel_load", "id"), &Core::CancelLoad);
+        godot::ClassDB::bind_method(godot::D_METHOD("cancel_all_loads"), &Core::CancelAllLoads);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_load_status", "id"), &Core::GetLoadStatus);
+        godot::ClassDB::bind_method(godot::D_METHOD("wait_for_load", "id"), &Core::WaitForLoad);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_load_progress", "id"), &Core::GetLoadProgress);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_level_load_progress", "path"), &Core::GetLevelLoadProgress);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_loader_stats"), &Core::GetLoaderStats);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_batch_stats", "id"), &Core::GetBatchStats);
+
+        ADD_PROPERTY(godot::PropertyInfo(godot::Variant::BOOL, "use_worker_thread_pool"), "set_use_worker_thread_pool", "is_using_worker_thread_pool");
+        godot::ClassDB::bind_method(godot::D_METHOD("set_completion_budget_usec", "usec"), &Core::SetCompletionBudgetUsec);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_completion_budget_usec"), &Core::GetCompletionBudgetUsec);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_completion_stats"), &Core::GetCompletionStats);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_completion_queue_depth"), &Core::GetCompletionQueueDepth);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_completion_drain_msec"), &Core::GetCompletionDrainMsec);
+        godot::ClassDB::bind_method(godot::D_METHOD("set_log_level", "level"), &Core::SetLogLevel);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_log_level"), &Core::GetLogLevel);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_log_stats"), &Core::GetLogStats);
+        godot::ClassDB::bind_method(godot::D_METHOD("set_chunk_profiling", "enabled"), &Core::SetChunkProfiling);
+        godot::ClassDB::bind_method(godot::D_METHOD("is_chunk_profiling"), &Core::IsChunkProfiling);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_chunk_profile"), &Core::GetChunkProfile);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_chunk_profile_json"), &Core::GetChunkProfileJson);
+        godot::ClassDB::bind_method(godot::D_METHOD("reset_chunk_profile"), &Core::ResetChunkProfile);
+        godot::ClassDB::bind_method(godot::D_METHOD("register_load_profile", "name", "skips"), &Core::RegisterLoadProfile);
+        godot::ClassDB::bind_method(godot::D_METHOD("set_load_profile", "name"), &Core::SetLoadProfile);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_load_profile"), &Core::GetLoadProfile);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_load_profiles"), &Core::GetLoadProfiles);
+        godot::ClassDB::bind_method(godot::D_METHOD("open_hash_dictionary", "filename"), &Core::OpenHashDictionary);
+        godot::ClassDB::bind_method(godot::D_METHOD("write_hash_dictionary", "filename", "names"), &Core::WriteHashDictionary);
+        godot::ClassDB::bind_method(godot::D_METHOD("lookup_hash", "hash"), &Core::LookupHash);
+        godot::ClassDB::bind_method(godot::D_METHOD("has_entity_class", "name"), &Core::HasEntityClass);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_class_property", "name", "property"), &Core::GetClassProperty);
+        godot::ClassDB::bind_method(godot::D_METHOD("set_class_property", "name", "property", "value"), &Core::SetClassProperty);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_entity_class_count"), &Core::GetEntityClassCount);
+
+        ADD_PROPERTY(godot::PropertyInfo(godot::Variant::BOOL, "lazy_model_decoding"), "set_lazy_model_decoding", "is_lazy_model_decoding");
+        ADD_PROPERTY(godot::PropertyInfo(godot::Variant::BOOL, "create_meshes_on_load"), "set_create_meshes_on_load", "is_creating_meshes_on_load");
+        ADD_PROPERTY(godot::PropertyInfo(godot::Variant::INT, "completion_budget_usec"), "set_completion_budget_usec", "get_completion_budget_usec");
+        ADD_PROPERTY(godot::PropertyInfo(godot::Variant::INT, "log_level"), "set_log_level", "get_log_level");
+        ADD_PROPERTY(godot::PropertyInfo(godot::Variant::BOOL, "chunk_profiling"), "set_chunk_profiling", "is_chunk_profiling");
+        ADD_PROPERTY(godot::PropertyInfo(godot::Variant::STRING, "load_profile"), "set_load_profile", "get_load_profile");
+
+        ADD_SIGNAL(godot::MethodInfo("load_finished", godot::PropertyInfo(godot::Variant::INT, "id"), godot::PropertyInfo(godot::Variant::INT, "status")));
+        ADD_SIGNAL(godot::MethodInfo("model_loaded", godot::PropertyInfo(godot::Variant::STRING, "name")));
+
+        godot::ClassDB::bind_integer_constant(get_class_static(), "ModelRetention", "RETENTION_KEEP_ALL", static_cast<int64_t>(ModelRetention::KeepAll));
+        godot::ClassDB::bind_integer_constant(get_class_static(), "ModelRetention", "RETENTION_RELEASE_AFTER_UPLOAD", static_cast<int64_t>(ModelRetention::ReleaseAfterUpload));
+        godot::ClassDB::bind_integer_constant(get_class_static(), "ModelRetention", "RETENTION_KEEP_COLLISION", static_cast<int64_t>(ModelRetention::KeepCollision));
+
+        godot::ClassDB::bind_integer_constant(get_class_static(), "LoadPriority", "LOAD_PRIORITY_BLOCKING", static_cast<int64_t>(TaskPriority::Blocking));
+        godot::ClassDB::bind_integer_constant(get_class_static(), "LoadPriority", "LOAD_PRIORITY_VISIBLE", static_cast<int64_t>(TaskPriority::Visible));
+        godot::ClassDB::bind_integer_constant(get_class_static(), "LoadPriority", "LOAD_PRIORITY_BACKGROUND", static_cast<int64_t>(TaskPriority::Background));
+
+        godot::ClassDB::bind_integer_constant(get_class_static(), "LoadStatus", "LOAD_QUEUED", static_cast<int64_t>(LoadStatus::Queued));
+        godot::ClassDB::bind_integer_constant(get_class_static(), "LoadStatus", "LOAD_LOADING", static_cast<int64_t>(LoadStatus::Loading));
+        godot::ClassDB::bind_integer_constant(get_class_static(), "LoadStatus", "LOAD_FINISHED", static_cast<int64_t>(LoadStatus::Finished));
+        godot::ClassDB::bind_integer_constant(get_class_static(), "LoadStatus", "LOAD_CANCELLED", static_cast<int64_t>(LoadStatus::Cancelled));
+        godot::ClassDB::bind_integer_constant(get_class_static(), "LoadStatus", "LOAD_FAILED", static_cast<int64_t>(LoadStatus::Failed));
+
+        godot::ClassDB::bind_integer_constant(get_class_static(), "LogLevel", "LOG_VERBOSE", static_cast<int64_t>(LogLevel::Verbose));
+        godot::ClassDB::bind_integer_constant(get_class_static(), "LogLevel", "LOG_INFO", static_cast<int64_t>(LogLevel::Info));
+        godot::ClassDB::bind_integer_constant(get_class_static(), "LogLevel", "LOG_WARNING", static_cast<int64_t>(LogLevel::Warning));
+        godot::ClassDB::bind_integer_constant(get_class_static(), "LogLevel", "LOG_ERROR", static_cast<int64_t>(LogLevel::Error));
     }
 }
@@ -1,16 +1,121 @@
 #pragma once
 
+#include <godot_cpp/classes/array_mesh.hpp>
 #include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+#include <godot_cpp/variant/rid.hpp>
 
-class Core : public godot::Node {
-GDCLASS(Core, godot::Node)
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
-public:
-    Core();
-    ~Core() = default;
+namespace SWBF2
+{
+    class LoadBatch;
+    class LoadRequest;
 
-    void _ready() override;
+    class Core : public godot::Node {
+    GDCLASS(Core, godot::Node)
 
-private:
-    static void _bind_methods();
-};
+    public:
+        Core();
+        ~Core() = default;
+
+        void _ready() override;
+        void _process(double delta) override;
+        void _exit_tree() override;
+
+        godot::Dictionary GetModelCacheStats() const;
+        void SetModelMemoryBudget(int64_t bytes);
+        void SetModelRetention(const godot::String &name, int64_t retention);
+        void SetDefaultModelRetention(int64_t retention);
+        godot::Ref<godot::ArrayMesh> GetModelMesh(const godot::String &name);
+
+        // Decodes every model while loading, even with lazy_model_decoding set
+        void SetCreateMeshesOnLoad(bool create);
+        bool IsCreatingMeshesOnLoad() const;
+        godot::RID GetModelMeshRid(const godot::String &name) const;
+
+        void SetUseWorkerThreadPool(bool use);
+        bool IsUsingWorkerThreadPool() const;
+
+        void SetLazyModelDecoding(bool lazy);
+        bool IsLazyModelDecoding() const;
+
+        godot::Dictionary GetMemoryUsage() const;
+        void SetLevelMemoryBudget(const godot::String &level, int64_t bytes);
+
+        int64_t GetTotalMemoryBytes() const;
+        int64_t GetModelMemoryBytes() const;
+        int64_t GetLevelMemoryBytes(const godot::String &level) const;
+
+        godot::Dictionary BenchmarkLevelLoad(const godot::String &filename, int64_t maxThreads, int64_t repeats);
+        godot::Dictionary BenchmarkHashing(const godot::PackedStringArray &names, int64_t repeats);
+        godot::Dictionary BenchmarkMeshBuild(const godot::PackedStringArray &names, int64_t repeats);
+        godot::Dictionary BenchmarkLoadProfiles(const godot::PackedStringArray &filenames, const godot::String &baseline, const godot::String &candidate, int64_t repeats);
+        godot::Dictionary BenchmarkLoadGraph(int64_t nodes, int64_t repeats);
+        godot::Dictionary BenchmarkCompletionQueue(int64_t producers, int64_t tasksPerProducer, int64_t budgetUsec);
+
+        // Ids are known until the handlers of their load_finished signal returned
+        int64_t LoadLevel(const godot::String &filename, int64_t priority);
+        int64_t LoadLevels(const godot::PackedStringArray &filenames, int64_t priority);
+        void CancelLoad(int64_t id);
+        void CancelAllLoads();
+        int64_t GetLoadStatus(int64_t id) const;
+        void WaitForLoad(int64_t id);
+        double GetLoadProgress(int64_t id) const;
+        double GetLevelLoadProgress(const godot::String &path) const; // of ResourceLoader loads
+        godot::Dictionary GetLoaderStats() const;
+        godot::Dictionary GetBatchStats(int64_t id) const;
+
+        void SetCompletionBudgetUsec(int64_t usec);
+        int64_t GetCompletionBudgetUsec() const;
+        godot::Dictionary GetCompletionStats() const;
+        int64_t GetCompletionQueueDepth() const;
+        double GetCompletionDrainMsec() const;
+
+        void SetLogLevel(int64_t level);
+        int64_t GetLogLevel() const;
+        godot::Dictionary GetLogStats() const;
+
+        void SetChunkProfiling(bool enabled);
+        bool IsChunkProfiling() const;
+        godot::Dictionary GetChunkProfile() const;
+        godot::String GetChunkProfileJson() const;
+        void ResetChunkProfile();
+
+        bool RegisterLoadProfile(const godot::String &name, const godot::PackedStringArray &skips);
+        void SetLoadProfile(const godot::String &name);
+        godot::String GetLoadProfile() const;
+        godot::PackedStringArray GetLoadProfiles() const;
+
+        bool OpenHashDictionary(const godot::String &filename);
+        bool WriteHashDictionary(const godot::String &filename, const godot::PackedStringArray &names);
+        godot::String LookupHash(int64_t hash) const;
+
+        bool HasEntityClass(const godot::String &name) const;
+        godot::String GetClassProperty(const godot::String &name, const godot::String &property) const;
+        void SetClassProperty(const godot::String &name, const godot::String &property, const godot::String &value);
+        int64_t GetEntityClassCount() const;
+
+    private:
+        static void _bind_methods();
+
+        bool IsLoading() const;
+
+        // Runs function on the main thread with the Core, if it still exists by then
+        static void QueueOnMainThread(uint64_t coreId, std::function<void(Core &core)> function);
+
+        std::vector<godot::StringName> m_monitors;
+        bool m_useWorkerThreadPool = true;
+
+        std::unordered_map<int64_t, std::shared_ptr<LoadRequest>> m_loads;
+        std::unordered_map<int64_t, std::shared_ptr<LoadBatch>> m_batches; // ids shared with m_loads
+        int64_t m_nextLoadId = 1;
+
+        int64_t m_completionBudgetUsec = 2000;
+    };
+}
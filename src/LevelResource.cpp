@@ -0,0 +1,51 @@
+#include <godot_cpp/core/class_db.hpp>
+
+#include "LevelResource.hpp"
+
+#include "SWBF2/Models.hpp"
+
+namespace SWBF2
+{
+    void LevelResource::SetLevelPath(const godot::String &path)
+    {
+        m_levelPath = path;
+    }
+
+    godot::String LevelResource::GetLevelPath() const
+    {
+        return m_levelPath;
+    }
+
+    void LevelResource::SetLoadMsec(double msec)
+    {
+        m_loadMsec = msec;
+    }
+
+    double LevelResource::GetLoadMsec() const
+    {
+        return m_loadMsec;
+    }
+
+    godot::PackedStringArray LevelResource::GetModelNames() const
+    {
+        const std::string level = m_levelPath.utf8().get_data();
+
+        godot::PackedStringArray names;
+        for (const auto &usage : Models::GetMemoryUsage())
+        {
+            if (usage.m_level == level)
+            {
+                names.push_back(usage.m_name.c_str());
+            }
+        }
+
+        return names;
+    }
+
+    void LevelResource::_bind_methods()
+    {
+        godot::ClassDB::bind_method(godot::D_METHOD("get_level_path"), &LevelResource::GetLevelPath);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_load_msec"), &LevelResource::GetLoadMsec);
+        godot::ClassDB::bind_method(godot::D_METHOD("get_model_names"), &LevelResource::GetModelNames);
+    }
+}
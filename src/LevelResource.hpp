@@ -0,0 +1,28 @@
+#pragma once
+
+#include <godot_cpp/classes/resource.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+
+namespace SWBF2
+{
+    // A lvl file loaded through ResourceLoader. What it read stays in the shared
+    // caches, like for Core.load_level; this only names the file it came from.
+    class LevelResource : public godot::Resource {
+    GDCLASS(LevelResource, godot::Resource)
+
+    public:
+        void SetLevelPath(const godot::String &path);
+        godot::String GetLevelPath() const; // the file path the caches know the level by
+
+        void SetLoadMsec(double msec);
+        double GetLoadMsec() const;
+
+        godot::PackedStringArray GetModelNames() const;
+
+    private:
+        static void _bind_methods();
+
+        godot::String m_levelPath;
+        double m_loadMsec = 0.0;
+    };
+}
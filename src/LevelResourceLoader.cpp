@@ -0,0 +1,90 @@
+#include <godot_cpp/classes/project_settings.hpp>
+
+#include <algorithm>
+
+#include "LevelResource.hpp"
+#include "LevelResourceLoader.hpp"
+
+#include "SWBF2/LevelLoader.hpp"
+
+namespace SWBF2
+{
+    std::mutex LevelResourceLoader::m_mutex;
+    std::unordered_map<std::string, std::vector<std::shared_ptr<LoadRequest>>> LevelResourceLoader::m_loads;
+
+    godot::PackedStringArray LevelResourceLoader::_get_recognized_extensions() const
+    {
+        godot::PackedStringArray extensions;
+        extensions.push_back("lvl");
+        return extensions;
+    }
+
+    bool LevelResourceLoader::_handles_type(const godot::StringName &type) const
+    {
+        return type == godot::StringName("LevelResource") || type == godot::StringName("Resource");
+    }
+
+    godot::String LevelResourceLoader::_get_resource_type(const godot::String &path) const
+    {
+        return path.get_extension().to_lower() == "lvl" ? "LevelResource" : "";
+    }
+
+    godot::Variant LevelResourceLoader::_load(const godot::String &path, const godot::String &originalPath, bool useSubThreads, int32_t cacheMode) const
+    {
+        const std::string key = path.utf8().get_data();
+        const auto filename = godot::ProjectSettings::get_singleton()->globalize_path(path);
+
+        // ResourceLoader already runs this on one of its threads for load_threaded_request,
+        // the chunks still spread over the executor like any other load
+        auto request = LevelLoader::Load(filename.utf8().get_data(), TaskPriority::Visible);
+        {
+            std::lock_guard lock{ m_mutex };
+            m_loads[key].push_back(request);
+        }
+
+        request->Wait();
+
+        {
+            // CACHE_MODE_IGNORE lets several loads of one path run at once
+            std::lock_guard lock{ m_mutex };
+
+            auto &loads = m_loads[key];
+            std::erase(loads, request);
+            if (loads.empty())
+            {
+                m_loads.erase(key);
+            }
+        }
+
+        if (request->GetStatus() != LoadStatus::Finished)
+        {
+            return static_cast<int64_t>(godot::ERR_FILE_CANT_READ);
+        }
+
+        godot::Ref<LevelResource> level;
+        level.instantiate();
+        level->SetLevelPath(filename);
+        level->SetLoadMsec(request->GetMilliseconds());
+
+        return level;
+    }
+
+    double LevelResourceLoader::GetProgress(const godot::String &path)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        auto it = m_loads.find(path.utf8().get_data());
+        if (it == m_loads.end())
+        {
+            return -1.0;
+        }
+
+        auto progress = 1.0;
+        for (const auto &request : it->second)
+        {
+            progress = std::min(progress, request->GetProgress());
+        }
+
+        return progress;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <godot_cpp/classes/resource_format_loader.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SWBF2
+{
+    class LoadRequest;
+
+    // Lets ResourceLoader.load and load_threaded_request read lvl files into
+    // LevelResources. ResourceLoader caches them by path, so loading a path
+    // it still holds returns the same resource without reading the file again.
+    class LevelResourceLoader : public godot::ResourceFormatLoader {
+    GDCLASS(LevelResourceLoader, godot::ResourceFormatLoader)
+
+    public:
+        godot::PackedStringArray _get_recognized_extensions() const override;
+        bool _handles_type(const godot::StringName &type) const override;
+        godot::String _get_resource_type(const godot::String &path) const override;
+        godot::Variant _load(const godot::String &path, const godot::String &originalPath, bool useSubThreads, int32_t cacheMode) const override;
+
+        // 0 to 1 for a load of path in flight, the least progressed one when several
+        // are, -1 when there is none. A format loader cannot report to
+        // load_threaded_get_status, so poll this instead.
+        static double GetProgress(const godot::String &path);
+
+    private:
+        static void _bind_methods() {}
+
+        static std::mutex m_mutex;
+        static std::unordered_map<std::string, std::vector<std::shared_ptr<LoadRequest>>> m_loads; // by the path given to ResourceLoader
+    };
+}
@@ -0,0 +1,358 @@
+#include <godot_cpp/classes/mesh_instance3d.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include "ModelMesh.hpp"
+
+#include "SWBF2/Logging.hpp"
+#include "SWBF2/Models.hpp"
+#include "SWBF2/Threading/Executor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <latch>
+#include <limits>
+#include <optional>
+
+namespace SWBF2
+{
+    std::atomic<bool> ModelMesh::m_createOnLoad{ false };
+    std::mutex ModelMesh::m_mutex;
+    std::unordered_map<std::string, godot::RID> ModelMesh::m_meshes;
+
+    namespace
+    {
+        std::optional<godot::Mesh::PrimitiveType> GetPrimitive(const Model &model, const ModelSegment &segment)
+        {
+            switch (segment.m_info.m_topology)
+            {
+                case Topology::PointList: return godot::Mesh::PRIMITIVE_POINTS;
+                case Topology::LineList: return godot::Mesh::PRIMITIVE_LINES;
+                case Topology::LineStrip: return godot::Mesh::PRIMITIVE_LINE_STRIP;
+                case Topology::TriangleList: return godot::Mesh::PRIMITIVE_TRIANGLES;
+                case Topology::TriangleStrip: return godot::Mesh::PRIMITIVE_TRIANGLE_STRIP;
+                default:
+                    SWBF2_LOG(LogLevel::Warning, __FILE__, ":", __LINE__, ": topology ", static_cast<uint32_t>(segment.m_info.m_topology), " of ", model.m_name.c_str(), " not implemented");
+                    return std::nullopt;
+            }
+        }
+
+        // Fills the packed arrays through ptrw, set would copy-on-write check every element
+        godot::Array MakeSurfaceArrays(const ModelSegment &segment)
+        {
+            const auto &vbuf = segment.m_verticesBuf;
+            const auto vertexCount = vbuf.m_positions.size();
+
+            godot::PackedVector3Array positions;
+            positions.resize(vertexCount);
+            auto *positionsData = positions.ptrw();
+            for (std::size_t i = 0; i < vertexCount; ++i)
+            {
+                positionsData[i] = { vbuf.m_positions[i].x, vbuf.m_positions[i].y, vbuf.m_positions[i].z };
+            }
+
+            godot::Array arrays;
+            arrays.resize(godot::Mesh::ARRAY_MAX);
+            arrays[godot::Mesh::ARRAY_VERTEX] = positions;
+
+            if (vbuf.m_normals.size() == vertexCount)
+            {
+                godot::PackedVector3Array normals;
+                normals.resize(vertexCount);
+                auto *normalsData = normals.ptrw();
+                for (std::size_t i = 0; i < vertexCount; ++i)
+                {
+                    normalsData[i] = { vbuf.m_normals[i].x, vbuf.m_normals[i].y, vbuf.m_normals[i].z };
+                }
+                arrays[godot::Mesh::ARRAY_NORMAL] = normals;
+            }
+
+            if (vbuf.m_texCoords.size() == vertexCount)
+            {
+                godot::PackedVector2Array uvs;
+                uvs.resize(vertexCount);
+                auto *uvsData = uvs.ptrw();
+                for (std::size_t i = 0; i < vertexCount; ++i)
+                {
+                    uvsData[i] = { vbuf.m_texCoords[i].x, vbuf.m_texCoords[i].y };
+                }
+                arrays[godot::Mesh::ARRAY_TEX_UV] = uvs;
+            }
+
+            if (vbuf.m_colors.size() == vertexCount)
+            {
+                godot::PackedColorArray colors;
+                colors.resize(vertexCount);
+                auto *colorsData = colors.ptrw();
+                for (std::size_t i = 0; i < vertexCount; ++i)
+                {
+                    const auto &c = vbuf.m_colors[i].color;
+                    colorsData[i] = godot::Color::from_rgba8(c.r, c.g, c.b, c.a);
+                }
+                arrays[godot::Mesh::ARRAY_COLOR] = colors;
+            }
+
+            if (!segment.m_indicesBuf.m_indices.empty())
+            {
+                const auto &indices = segment.m_indicesBuf.m_indices;
+
+                godot::PackedInt32Array packed;
+                packed.resize(indices.size());
+                std::copy(indices.begin(), indices.end(), packed.ptrw());
+                arrays[godot::Mesh::ARRAY_INDEX] = packed;
+            }
+
+            return arrays;
+        }
+
+        double ToMillisecondsPer1000(std::chrono::steady_clock::duration duration, std::size_t segments)
+        {
+            return std::chrono::duration<double, std::milli>(duration).count() * 1000.0 / segments;
+        }
+    }
+
+    godot::Ref<godot::ArrayMesh> ModelMesh::Build(const Model &model)
+    {
+        godot::Ref<godot::ArrayMesh> mesh;
+        mesh.instantiate();
+
+        for (const auto &segment : model.m_segments)
+        {
+            if (segment.m_verticesBuf.m_positions.empty())
+            {
+                continue;
+            }
+
+            if (auto primitive = GetPrimitive(model, segment))
+            {
+                mesh->add_surface_from_arrays(*primitive, MakeSurfaceArrays(segment));
+            }
+        }
+
+        return mesh;
+    }
+
+    godot::Ref<godot::ArrayMesh> ModelMesh::Upload(const std::string &name)
+    {
+        auto model = Models::Get(name, ModelDetail::Full);
+        if (!model)
+        {
+            godot::UtilityFunctions::printerr(__FILE__, ":", __LINE__, ": model ", name.c_str(), " not found");
+            return {};
+        }
+
+        auto mesh = Build(*model);
+
+        Models::OnUploaded(name, model);
+
+        return mesh;
+    }
+
+    godot::RID ModelMesh::Create(const Model &model)
+    {
+        auto *renderingServer = godot::RenderingServer::get_singleton();
+        auto mesh = renderingServer->mesh_create();
+
+        for (const auto &segment : model.m_segments)
+        {
+            if (segment.m_verticesBuf.m_positions.empty())
+            {
+                continue;
+            }
+
+            // Mesh and RenderingServer number their primitive types the same
+            if (auto primitive = GetPrimitive(model, segment))
+            {
+                renderingServer->mesh_add_surface_from_arrays(mesh, static_cast<godot::RenderingServer::PrimitiveType>(*primitive), MakeSurfaceArrays(segment));
+            }
+        }
+
+        return mesh;
+    }
+
+    void ModelMesh::SetCreateOnLoad(bool enabled)
+    {
+        m_createOnLoad.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool ModelMesh::IsCreatingOnLoad()
+    {
+        return m_createOnLoad.load(std::memory_order_relaxed);
+    }
+
+    void ModelMesh::OnModelInserted(const std::string &name)
+    {
+        if (!IsCreatingOnLoad())
+        {
+            return;
+        }
+
+        auto model = Models::Get(name, ModelDetail::Full);
+        if (!model)
+        {
+            return;
+        }
+
+        auto mesh = Create(*model);
+
+        Models::OnUploaded(name, model);
+
+        godot::RID replaced;
+        {
+            std::lock_guard lock{ m_mutex };
+
+            auto &entry = m_meshes[name];
+            replaced = entry;
+            entry = mesh;
+        }
+
+        // a later level provided the same name
+        if (replaced.is_valid())
+        {
+            godot::RenderingServer::get_singleton()->free_rid(replaced);
+        }
+
+        // the level may have been removed while the mesh was made, after its remove observer ran
+        if (!Models::Contains(name))
+        {
+            OnModelRemoved(name);
+        }
+    }
+
+    void ModelMesh::OnModelRemoved(const std::string &name)
+    {
+        godot::RID mesh;
+        {
+            std::lock_guard lock{ m_mutex };
+
+            auto it = m_meshes.find(name);
+            if (it == m_meshes.end())
+            {
+                return;
+            }
+
+            mesh = it->second;
+            m_meshes.erase(it);
+        }
+
+        godot::RenderingServer::get_singleton()->free_rid(mesh);
+    }
+
+    godot::RID ModelMesh::GetMesh(const std::string &name)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        auto it = m_meshes.find(name);
+        return it != m_meshes.end() ? it->second : godot::RID{};
+    }
+
+    void ModelMesh::FreeMeshes()
+    {
+        std::unordered_map<std::string, godot::RID> meshes;
+        {
+            std::lock_guard lock{ m_mutex };
+            meshes.swap(m_meshes);
+        }
+
+        auto *renderingServer = godot::RenderingServer::get_singleton();
+        for (const auto &[name, mesh] : meshes)
+        {
+            renderingServer->free_rid(mesh);
+        }
+    }
+
+    MeshBuildBenchmarkResult ModelMesh::BenchmarkBuild(const std::vector<std::string> &names, std::size_t repeats)
+    {
+        std::vector<std::shared_ptr<const Model>> models;
+        std::size_t segments = 0;
+        for (const auto &name : names)
+        {
+            if (auto model = Models::Get(name, ModelDetail::Full))
+            {
+                segments += model->m_segments.size();
+                models.push_back(std::move(model));
+            }
+        }
+
+        if (segments == 0)
+        {
+            return {};
+        }
+
+        auto *renderingServer = godot::RenderingServer::get_singleton();
+
+        auto bestNodes = std::chrono::steady_clock::duration::max();
+        auto bestServer = std::chrono::steady_clock::duration::max();
+        auto bestServerWall = std::chrono::steady_clock::duration::max();
+
+        for (std::size_t repeat = 0; repeat < std::max<std::size_t>(repeats, 1); ++repeat)
+        {
+            // what Upload costs a scene that shows every model
+            std::vector<godot::MeshInstance3D *> nodes;
+            nodes.reserve(models.size());
+
+            auto start = std::chrono::steady_clock::now();
+            for (const auto &model : models)
+            {
+                auto *node = memnew(godot::MeshInstance3D);
+                node->set_mesh(Build(*model));
+                nodes.push_back(node);
+            }
+            bestNodes = std::min(bestNodes, std::chrono::steady_clock::now() - start);
+
+            for (auto *node : nodes)
+            {
+                memdelete(node);
+            }
+
+            // the same with the meshes made on workers, the main thread only instances them.
+            // It blocks on the latch instead of helping, a frame would go on meanwhile.
+            std::vector<godot::RID> meshes(models.size());
+            std::vector<godot::RID> instances;
+            instances.reserve(models.size());
+            std::latch created{ static_cast<std::ptrdiff_t>(models.size()) };
+
+            start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < models.size(); ++i)
+            {
+                Executor::GetDefault().Submit([&, i]
+                    {
+                        meshes[i] = Create(*models[i]);
+                        created.count_down();
+                    });
+            }
+            const auto submitted = std::chrono::steady_clock::now();
+
+            created.wait();
+
+            const auto instancing = std::chrono::steady_clock::now();
+            for (const auto &mesh : meshes)
+            {
+                auto instance = renderingServer->instance_create();
+                renderingServer->instance_set_base(instance, mesh);
+                instances.push_back(instance);
+            }
+            const auto end = std::chrono::steady_clock::now();
+
+            bestServer = std::min(bestServer, (submitted - start) + (end - instancing));
+            bestServerWall = std::min(bestServerWall, end - start);
+
+            for (const auto &instance : instances)
+            {
+                renderingServer->free_rid(instance);
+            }
+
+            for (const auto &mesh : meshes)
+            {
+                renderingServer->free_rid(mesh);
+            }
+        }
+
+        return {
+            segments,
+            ToMillisecondsPer1000(bestNodes, segments),
+            ToMillisecondsPer1000(bestServer, segments),
+            ToMillisecondsPer1000(bestServerWall, segments),
+        };
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/variant/rid.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include "SWBF2/Model.hpp"
+
+namespace SWBF2
+{
+    typedef struct _MESH_BUILD_BENCHMARK_RESULT
+    {
+        std::size_t m_segments;
+        double m_nodeMillisecondsPer1000;   // ArrayMesh and MeshInstance3D per model, all on the main thread
+        double m_serverMillisecondsPer1000; // main thread only: submitting to workers and instancing their RIDs
+        double m_serverWallMillisecondsPer1000; // until the last worker created its mesh
+    } MeshBuildBenchmarkResult;
+
+    class ModelMesh {
+    public:
+        static godot::Ref<godot::ArrayMesh> Build(const Model &model);
+
+        // Builds the mesh from the full model, then applies the model's retention policy
+        static godot::Ref<godot::ArrayMesh> Upload(const std::string &name);
+
+        // Creates the mesh on the RenderingServer without a Mesh resource. Unlike
+        // Build it may run on any thread, as long as the project renders with a
+        // thread-safe RenderingServer. The caller owns the RID.
+        static godot::RID Create(const Model &model);
+
+        // While enabled, every model a level read adds gets its mesh created on the
+        // loading thread. The RIDs are kept here until their model leaves the cache,
+        // GetMesh hands them out to be instanced or wrapped later. This needs the
+        // full model, so with lazy decoding every model is decoded during the load anyway.
+        static void SetCreateOnLoad(bool enabled);
+        static bool IsCreatingOnLoad();
+        static void OnModelInserted(const std::string &name); // nothing unless creating on load
+        static void OnModelRemoved(const std::string &name);  // frees the model's mesh
+        static godot::RID GetMesh(const std::string &name);   // invalid until created
+        static void FreeMeshes();
+
+        // Main thread time per 1,000 segments of names, best of repeats
+        static MeshBuildBenchmarkResult BenchmarkBuild(const std::vector<std::string> &names, std::size_t repeats);
+
+    private:
+        static std::atomic<bool> m_createOnLoad;
+        static std::mutex m_mutex;
+        static std::unordered_map<std::string, godot::RID> m_meshes;
+    };
+}
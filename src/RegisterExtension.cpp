@@ -2,17 +2,33 @@
 
 #include <gdextension_interface.h>
 
+#include <godot_cpp/classes/resource_loader.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/core/defs.hpp>
 #include <godot_cpp/godot.hpp>
 
 #include "Core.hpp"
+#include "LevelResource.hpp"
+#include "LevelResourceLoader.hpp"
+#include "ModelMesh.hpp"
+
+#include "SWBF2/Chunks/ChunkProfiler.hpp"
+#include "SWBF2/Chunks/Hashing.hpp"
+#include "SWBF2/Chunks/LoadProfile.hpp"
+#include "SWBF2/EntityClasses.hpp"
+#include "SWBF2/Logging.hpp"
+#include "SWBF2/MemoryAccounting.hpp"
+#include "SWBF2/Models.hpp"
+#include "SWBF2/Threading/CompletionQueue.hpp"
+#include "SWBF2/Threading/Executor.hpp"
 
 /// @file
 /// Register our classes with Godot.
 
 namespace
 {
+    godot::Ref<SWBF2::LevelResourceLoader> levelResourceLoader;
+
     /// @brief Called by Godot to let us register our classes with Godot.
     ///
     /// @param p_level the level being initialized by Godot
@@ -26,6 +42,11 @@ namespace
         }
 
         godot::ClassDB::register_class<SWBF2::Core>();
+        godot::ClassDB::register_class<SWBF2::LevelResource>();
+        godot::ClassDB::register_class<SWBF2::LevelResourceLoader>();
+
+        levelResourceLoader.instantiate();
+        godot::ResourceLoader::get_singleton()->add_resource_format_loader(levelResourceLoader);
     }
 
     /// @brief Called by Godot to let us do any cleanup.
@@ -37,6 +58,29 @@ namespace
         {
             return;
         }
+
+        godot::ResourceLoader::get_singleton()->remove_resource_format_loader(levelResourceLoader);
+        levelResourceLoader.unref();
+
+        // the Godot backend has to finish its tasks while the engine is still around
+        SWBF2::Executor::Shutdown();
+
+        // no worker creates meshes anymore, the RenderingServer is still up at this level
+        SWBF2::ModelMesh::FreeMeshes();
+
+        // Extension state lives in ordinary statics and all of it is cleared here,
+        // once no worker runs. Static destruction then only frees empty containers,
+        // whatever order the translation units are torn down in.
+        SWBF2::Models::Clear();
+        SWBF2::EntityClasses::Clear();
+        SWBF2::MemoryAccounting::Clear();
+        SWBF2::CompletionQueue::GetMain().Clear();
+        SWBF2::FNV::CloseLookupTable();
+        SWBF2::ChunkProfiler::Reset();
+        SWBF2::LoadProfiles::Reset();
+
+        // prints what is still queued, the sink thread must not outlive the library
+        SWBF2::Logging::Shutdown();
     }
 }
 
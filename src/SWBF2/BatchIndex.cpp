@@ -0,0 +1,94 @@
+#include <algorithm>
+
+#include "BatchIndex.hpp"
+
+namespace SWBF2
+{
+    BatchIndex::BatchIndex(std::vector<std::string> filenames, CancellationToken batchToken)
+        : m_filenames(std::move(filenames)), m_batchToken(std::move(batchToken))
+    {
+    }
+
+    void BatchIndex::AddModel(const std::string &name, std::size_t file, std::size_t offset)
+    {
+        m_providers.insert_or_assign(name, ModelProvider{ file, offset });
+    }
+
+    bool BatchIndex::Claim(const std::string &name, const ModelInfo &info, const ModelSource &source)
+    {
+        const auto file = GetFile(source.m_filename);
+
+        std::lock_guard lock{ m_mutex };
+
+        auto it = m_providers.find(name);
+        if (it == m_providers.end())
+        {
+            return true;
+        }
+
+        auto &provider = it->second;
+        if (provider.m_file == file && provider.m_offset == source.m_offset)
+        {
+            provider.m_read = true;
+            return true;
+        }
+
+        // the provider and every earlier copy were lost, this copy takes over
+        if (!provider.m_held)
+        {
+            provider = ModelProvider{ file, source.m_offset, true, true };
+            return true;
+        }
+
+        provider.m_copies.push_back({ file, info, source });
+        ++m_duplicates;
+        return false;
+    }
+
+    void BatchIndex::OnFileFailed(const std::string &filename, bool cancelled)
+    {
+        const auto file = GetFile(filename);
+
+        // every file of a cancelled batch drops its models, there is nothing to hand over
+        const auto restore = !m_batchToken.IsCancelled();
+
+        // inserted under the lock, so a copy can't be handed a model while its own file fails
+        std::lock_guard lock{ m_mutex };
+
+        for (auto &[name, provider] : m_providers)
+        {
+            std::erase_if(provider.m_copies, [file](const auto &copy) { return copy.m_file == file; });
+
+            if (!provider.m_held || provider.m_file != file || (!cancelled && provider.m_read))
+            {
+                continue;
+            }
+
+            // the copy read last would have won without the lost file
+            auto best = std::ranges::max_element(provider.m_copies, {}, [](const auto &copy) { return std::pair{ copy.m_file, copy.m_source.m_offset }; });
+            if (!restore || best == provider.m_copies.end())
+            {
+                provider.m_held = false;
+                continue;
+            }
+
+            auto copy = std::move(*best);
+            provider.m_copies.erase(best);
+            provider.m_file = copy.m_file;
+            provider.m_offset = copy.m_source.m_offset;
+            provider.m_read = true;
+
+            Models::InsertLazy(name, copy.m_info, copy.m_source);
+        }
+    }
+
+    std::size_t BatchIndex::GetDuplicates() const
+    {
+        return m_duplicates.load();
+    }
+
+    std::size_t BatchIndex::GetFile(const std::string &filename) const
+    {
+        return std::ranges::find(m_filenames, filename) - m_filenames.begin();
+    }
+}
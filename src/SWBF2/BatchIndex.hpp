@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include "Types.hpp"
+
+#include "Threading/CancellationToken.hpp"
+
+#include "Models.hpp"
+
+namespace SWBF2
+{
+    // Which chunk provides each model name of a load batch, built before any
+    // file is decoded. Copies in other chunks are skipped but remembered: when
+    // the file of the provider is cancelled or fails before it read the model,
+    // the copy that would have won without it is inserted instead.
+    class BatchIndex {
+    public:
+        BatchIndex(std::vector<std::string> filenames, CancellationToken batchToken); // in batch order
+
+        // Planning only, chunks of a file in file order. The last one of a name provides it.
+        void AddModel(const std::string &name, std::size_t file, std::size_t offset);
+
+        // False when the model is a copy that another chunk provides
+        bool Claim(const std::string &name, const ModelInfo &info, const ModelSource &source);
+
+        // For a file that did not finish, before it drops what it read. A cancelled
+        // file loses every model, a failed one keeps those it reached. The models
+        // it loses go to the best remaining copy, and its own copies are forgotten.
+        void OnFileFailed(const std::string &filename, bool cancelled);
+
+        std::size_t GetDuplicates() const;
+
+    private:
+        typedef struct _MODEL_COPY
+        {
+            std::size_t m_file;
+            ModelInfo m_info;
+            ModelSource m_source;
+        } ModelCopy;
+
+        typedef struct _MODEL_PROVIDER
+        {
+            std::size_t m_file;
+            std::size_t m_offset;
+            bool m_held = true;  // false once no chunk of the batch provides it anymore
+            bool m_read = false; // the provider's chunk was reached
+            std::vector<ModelCopy> m_copies;
+        } ModelProvider;
+
+        std::size_t GetFile(const std::string &filename) const;
+
+        std::vector<std::string> m_filenames;
+        CancellationToken m_batchToken;
+
+        std::mutex m_mutex;
+        std::unordered_map<std::string, ModelProvider> m_providers;
+        std::atomic<std::size_t> m_duplicates{ 0 };
+    };
+}
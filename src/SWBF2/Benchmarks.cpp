@@ -0,0 +1,263 @@
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <latch>
+#include <thread>
+
+#include "Chunks/Hashing.hpp"
+#include "Chunks/LoadProfile.hpp"
+#include "Chunks/StreamReader.hpp"
+#include "Chunks/UcfbChunk.hpp"
+#include "Threading/CompletionQueue.hpp"
+#include "Threading/Executor.hpp"
+#include "Threading/LoadGraph.hpp"
+
+#include "Benchmarks.hpp"
+#include "MemoryAccounting.hpp"
+#include "Models.hpp"
+
+namespace SWBF2
+{
+    namespace
+    {
+        constexpr std::size_t GRAPH_LAYERS = 8; // one resource bit each
+    }
+
+    std::vector<LoadScalingResult> Benchmarks::LevelLoadScaling(const std::string &filename, std::size_t maxThreads, std::size_t repeats)
+    {
+        if (maxThreads == 0)
+        {
+            maxThreads = std::thread::hardware_concurrency();
+        }
+
+        std::vector<LoadScalingResult> results;
+
+        const auto backend = Executor::GetDefault().GetBackend();
+        const auto threadCount = Executor::GetDefault().GetThreadCount();
+
+        for (std::size_t threads = 1; threads <= maxThreads; ++threads)
+        {
+            Executor::SetDefault(ExecutorBackend::ThreadPool, threads);
+
+            double best = std::numeric_limits<double>::max();
+            for (std::size_t i = 0; i < std::max<std::size_t>(repeats, 1); ++i)
+            {
+                Models::Clear();
+
+                // read on a worker and wait without helping, so only the pool's threads run it
+                std::latch done{ 1 };
+
+                const auto start = std::chrono::steady_clock::now();
+                Executor::GetDefault().Submit([&]
+                    {
+                        UcfbChunk::ReadUcfbFile(filename);
+                        done.count_down();
+                    });
+                done.wait();
+                const auto end = std::chrono::steady_clock::now();
+
+                best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+            }
+
+            results.push_back({ threads, best, results.empty() ? 1.0 : results.front().m_milliseconds / best });
+        }
+
+        Executor::SetDefault(backend, threadCount);
+        Models::Clear();
+
+        return results;
+    }
+
+    std::vector<LoadProfileResult> Benchmarks::CompareLoadProfiles(const std::vector<std::string> &filenames, const std::vector<std::string> &profiles, std::size_t repeats)
+    {
+        std::vector<LoadProfileResult> results;
+
+        const auto active = LoadProfiles::GetActive().GetName();
+        const auto decodeMode = Models::GetDecodeMode();
+
+        // lazy decoding would leave the model work out of both the time and the memory
+        Models::SetDecodeMode(ModelDecodeMode::Eager);
+
+        for (const auto &profile : profiles)
+        {
+            if (!LoadProfiles::SetActive(profile))
+            {
+                continue;
+            }
+
+            double best = std::numeric_limits<double>::max();
+            for (std::size_t i = 0; i < std::max<std::size_t>(repeats, 1); ++i)
+            {
+                Models::Clear();
+
+                const auto start = std::chrono::steady_clock::now();
+                for (const auto &filename : filenames)
+                {
+                    UcfbChunk::ReadUcfbFile(filename);
+                }
+                const auto end = std::chrono::steady_clock::now();
+
+                best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+            }
+
+            results.push_back({ profile, best, Models::GetStats().m_residentBytes, MemoryAccounting::GetTotalBytes() });
+        }
+
+        LoadProfiles::SetActive(active);
+        Models::SetDecodeMode(decodeMode);
+        Models::Clear();
+
+        return results;
+    }
+
+    HashThroughputResult Benchmarks::HashThroughput(const std::vector<std::string> &names, std::size_t repeats)
+    {
+        const std::vector<std::string_view> views(names.begin(), names.end());
+
+        std::vector<FNVHash> scalar(names.size());
+        std::vector<FNVHash> batch(names.size());
+
+        double scalarBest = std::numeric_limits<double>::max();
+        double batchBest = std::numeric_limits<double>::max();
+
+        for (std::size_t i = 0; i < std::max<std::size_t>(repeats, 1); ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t j = 0; j < names.size(); ++j)
+            {
+                scalar[j] = FNV::Hash(names[j]);
+            }
+            const auto middle = std::chrono::steady_clock::now();
+            FNV::HashBatch(views, batch);
+            const auto end = std::chrono::steady_clock::now();
+
+            scalarBest = std::min(scalarBest, std::chrono::duration<double>(middle - start).count());
+            batchBest = std::min(batchBest, std::chrono::duration<double>(end - middle).count());
+        }
+
+        return { names.size() / std::max(scalarBest, 1e-9), names.size() / std::max(batchBest, 1e-9), scalar == batch };
+    }
+
+    LoadGraphResult Benchmarks::LoadGraphOrdering(std::size_t nodes, std::size_t repeats)
+    {
+        nodes = std::max(nodes, GRAPH_LAYERS);
+
+        std::array<std::size_t, GRAPH_LAYERS> layerSizes{};
+        for (std::size_t i = 0; i < nodes; ++i)
+        {
+            ++layerSizes[i * GRAPH_LAYERS / nodes];
+        }
+
+        double best = std::numeric_limits<double>::max();
+        bool ordered = true;
+
+        for (std::size_t i = 0; i < std::max<std::size_t>(repeats, 1); ++i)
+        {
+            std::array<std::atomic<std::size_t>, GRAPH_LAYERS> finished{};
+            std::atomic<bool> early{ false };
+
+            LoadGraph graph;
+
+            for (std::size_t layer = GRAPH_LAYERS; layer-- > 0;)
+            {
+                // odd layers also wait for the layer two back, so some nodes have two edges
+                uint32_t consumes = 0;
+                if (layer >= 1)
+                {
+                    consumes |= 1u << (layer - 1);
+                }
+                if (layer >= 2 && layer % 2 == 1)
+                {
+                    consumes |= 1u << (layer - 2);
+                }
+
+                for (std::size_t node = 0; node < layerSizes[layer]; ++node)
+                {
+                    graph.Add(static_cast<LoadResource>(1u << layer), static_cast<LoadResource>(consumes), [&, layer, consumes]
+                        {
+                            for (std::size_t input = 0; input < layer; ++input)
+                            {
+                                if ((consumes & (1u << input)) != 0 && finished[input].load(std::memory_order_acquire) != layerSizes[input])
+                                {
+                                    early.store(true, std::memory_order_relaxed);
+                                }
+                            }
+
+                            finished[layer].fetch_add(1, std::memory_order_release);
+                        });
+                }
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            graph.Run();
+            const auto end = std::chrono::steady_clock::now();
+
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+
+            for (std::size_t layer = 0; layer < GRAPH_LAYERS; ++layer)
+            {
+                ordered &= finished[layer] == layerSizes[layer];
+            }
+
+            ordered &= !early;
+        }
+
+        return { nodes, best, ordered };
+    }
+
+    CompletionQueueResult Benchmarks::CompletionQueueStress(std::size_t producers, std::size_t tasksPerProducer, std::chrono::microseconds budget)
+    {
+        producers = std::max<std::size_t>(producers, 1);
+
+        CompletionQueue queue;
+
+        // only touched by the tasks, so only by this thread
+        std::vector<uint64_t> next(producers, 0);
+        uint64_t ran = 0;
+        bool ordered = true;
+
+        std::latch started{ static_cast<std::ptrdiff_t>(producers + 1) };
+        std::vector<std::thread> threads;
+
+        for (std::size_t producer = 0; producer < producers; ++producer)
+        {
+            threads.emplace_back([&, producer]
+                {
+                    started.arrive_and_wait();
+
+                    for (uint64_t i = 0; i < tasksPerProducer; ++i)
+                    {
+                        queue.Push([&, producer, i]
+                            {
+                                ordered &= next[producer] == i;
+                                next[producer] = i + 1;
+                                ++ran;
+                            });
+                    }
+                });
+        }
+
+        const uint64_t tasks = static_cast<uint64_t>(producers) * tasksPerProducer;
+
+        started.arrive_and_wait();
+        const auto start = std::chrono::steady_clock::now();
+
+        while (ran < tasks)
+        {
+            if (queue.Drain(budget) == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        const auto end = std::chrono::steady_clock::now();
+
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        return { tasks, ran, std::chrono::duration<double, std::milli>(end - start).count(), ordered && queue.GetDepth() == 0 };
+    }
+}
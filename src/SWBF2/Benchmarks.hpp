@@ -0,0 +1,68 @@
+
+#pragma once
+
+#include <chrono>
+
+#include "Types.hpp"
+
+namespace SWBF2
+{
+    typedef struct _LOAD_SCALING_RESULT
+    {
+        std::size_t m_threadCount;
+        double m_milliseconds; // best of the repeats
+        double m_speedup;      // against one thread
+    } LoadScalingResult;
+
+    typedef struct _LOAD_PROFILE_RESULT
+    {
+        std::string m_profile;
+        double m_milliseconds;   // best of the repeats, all files
+        std::size_t m_modelBytes; // resident after the last repeat
+        std::size_t m_totalBytes; // models and source buffers
+    } LoadProfileResult;
+
+    typedef struct _HASH_THROUGHPUT_RESULT
+    {
+        double m_scalarNamesPerSecond; // FNV::Hash, best of the repeats
+        double m_batchNamesPerSecond;  // FNV::HashBatch
+        bool m_identical;
+    } HashThroughputResult;
+
+    typedef struct _LOAD_GRAPH_RESULT
+    {
+        std::size_t m_nodes;
+        double m_milliseconds; // best of the repeats
+        bool m_ordered;        // no node started before the producers of its inputs finished
+    } LoadGraphResult;
+
+    typedef struct _COMPLETION_QUEUE_RESULT
+    {
+        uint64_t m_tasks;      // pushed by all producers
+        uint64_t m_ran;
+        double m_milliseconds; // producers started until the last task ran
+        bool m_ordered;        // each producer's tasks ran in push order
+    } CompletionQueueResult;
+
+    class Benchmarks {
+    public:
+        // Loads the file on our own thread pool with 1 to maxThreads threads. Replaces
+        // the default executor, so it must not run while other loads are in flight.
+        static std::vector<LoadScalingResult> LevelLoadScaling(const std::string &filename, std::size_t maxThreads, std::size_t repeats);
+
+        // Loads the same files under each profile with eager decoding. Replaces the
+        // active profile and decode mode, so it must not run while other loads are in flight.
+        static std::vector<LoadProfileResult> CompareLoadProfiles(const std::vector<std::string> &filenames, const std::vector<std::string> &profiles, std::size_t repeats);
+
+        static HashThroughputResult HashThroughput(const std::vector<std::string> &names, std::size_t repeats);
+
+        // Runs a graph of layers on the default executor, each layer consuming what the
+        // one or two before it produce, added last layer first so every edge holds nodes back
+        static LoadGraphResult LoadGraphOrdering(std::size_t nodes, std::size_t repeats);
+
+        // Producer threads push to a queue of its own while this thread drains it in
+        // slices of budget, like Core each frame. Run it in a SWBF2_SANITIZE_THREAD
+        // build to have the queue checked for races.
+        static CompletionQueueResult CompletionQueueStress(std::size_t producers, std::size_t tasksPerProducer, std::chrono::microseconds budget);
+    };
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <utility>
+
+#include "../Types.hpp"
+
+namespace SWBF2
+{
+    // Entries keyed by chunk magic, sorted at compile time. Entry is any
+    // struct with a uint32_t m_magic, usually next to a plain function pointer.
+    // Key picks another member, like the parent and child pair of nested chunks.
+    template <typename Entry, std::size_t N, auto Key = &Entry::m_magic>
+    class ChunkDispatchTable {
+    public:
+        using KeyType = std::remove_cvref_t<decltype(std::declval<const Entry &>().*Key)>;
+
+        consteval explicit ChunkDispatchTable(std::array<Entry, N> entries)
+            : m_entries(entries)
+        {
+            std::ranges::sort(m_entries, {}, Key);
+
+            // a duplicate would make lookups depend on sort order, reject it while compiling
+            if (std::ranges::adjacent_find(m_entries, {}, Key) != m_entries.end())
+            {
+                throw "duplicate chunk magic in dispatch table";
+            }
+        }
+
+        constexpr const Entry *Find(KeyType key) const
+        {
+            auto it = std::ranges::lower_bound(m_entries, key, {}, Key);
+            return it != m_entries.end() && (*it).*Key == key ? &*it : nullptr;
+        }
+
+        constexpr bool Contains(KeyType key) const
+        {
+            return Find(key) != nullptr;
+        }
+
+        constexpr const std::array<Entry, N> &GetEntries() const
+        {
+            return m_entries;
+        }
+
+    private:
+        std::array<Entry, N> m_entries;
+    };
+
+    // For tables keyed by another member, which class template argument deduction can't pick
+    template <auto Key, typename Entry, std::size_t N>
+    consteval auto MakeChunkDispatchTable(std::array<Entry, N> entries)
+    {
+        return ChunkDispatchTable<Entry, N, Key>(entries);
+    }
+
+    // Entry for a magic known while compiling, so a call through it can be inlined
+    template <const auto &Table, uint32_t Magic>
+    constexpr const auto &GetChunkEntry()
+    {
+        constexpr auto *entry = Table.Find(Magic);
+        static_assert(entry != nullptr, "chunk magic has no entry in the dispatch table");
+        return *entry;
+    }
+}
@@ -1,48 +1,200 @@
-#include <set>
+#include <algorithm>
 #include <array>
-#include <map>
+#include <charconv>
 #include <string>
-#include <format>
 
+#include "ChunkDispatchTable.hpp"
 #include "ChunkHeader.hpp"
 
 namespace SWBF2
 {
-    const std::map<ChunkHeader, std::string> KNOWN_SOUND_HEADERS =
-    {
-        {"StreamList"_fnvh, 	"StreamList"},
-        {"Stream"_fnvh, 		"Stream"},
-        {"Info"_fnvh, 			"Info"},
-        {"SoundBankList"_fnvh, 	"SoundBankList"},
-        {"Data"_fnvh, 			"Data"},
-        {"SampleBank"_fnvh, 	"SampleBank"},
-    };
+    // Sorted while compiling, so a lookup is a binary search over a flat array
+    // and nothing is built when the library loads
+    constexpr ChunkDispatchTable KNOWN_HEADERS{ std::to_array<ChunkHeaderInfo>({
+        { "HEDR"_m, "HEDR", ChunkCategory::SourceMesh, true },
+        { "SHVO"_m, "SHVO", ChunkCategory::SourceMesh, false },
+        { "MSH2"_m, "MSH2", ChunkCategory::SourceMesh, true },
+        { "SINF"_m, "SINF", ChunkCategory::SourceMesh, true },
+        { "NAME"_m, "NAME", ChunkCategory::Field, false },
+        { "FRAM"_m, "FRAM", ChunkCategory::SourceMesh, false },
+        { "BBOX"_m, "BBOX", ChunkCategory::SourceMesh, false },
+        { "CAMR"_m, "CAMR", ChunkCategory::SourceMesh, false },
+        { "DATA"_m, "DATA", ChunkCategory::Field, false },
+        { "MATL"_m, "MATL", ChunkCategory::SourceMesh, true },
+        { "MATD"_m, "MATD", ChunkCategory::SourceMesh, true },
+        { "ATRB"_m, "ATRB", ChunkCategory::SourceMesh, false },
+        { "TX0D"_m, "TX0D", ChunkCategory::SourceMesh, false },
+        { "TX1D"_m, "TX1D", ChunkCategory::SourceMesh, false },
+        { "TX2D"_m, "TX2D", ChunkCategory::SourceMesh, false },
+        { "TX3D"_m, "TX3D", ChunkCategory::SourceMesh, false },
+        { "MODL"_m, "MODL", ChunkCategory::SourceMesh, true },
+        { "MTYP"_m, "MTYP", ChunkCategory::SourceMesh, false },
+        { "MNDX"_m, "MNDX", ChunkCategory::SourceMesh, false },
+        { "PRNT"_m, "PRNT", ChunkCategory::SourceMesh, false },
+        { "FLGS"_m, "FLGS", ChunkCategory::SourceMesh, false },
+        { "TRAN"_m, "TRAN", ChunkCategory::SourceMesh, false },
+        { "GEOM"_m, "GEOM", ChunkCategory::SourceMesh, true },
+        { "SEGM"_m, "SEGM", ChunkCategory::SourceMesh, true },
+        { "SHDW"_m, "SHDW", ChunkCategory::SourceMesh, true },
+        { "MATI"_m, "MATI", ChunkCategory::SourceMesh, false },
+        { "POSL"_m, "POSL", ChunkCategory::SourceMesh, false },
+        { "CLRL"_m, "CLRL", ChunkCategory::SourceMesh, false },
+        { "CLRB"_m, "CLRB", ChunkCategory::SourceMesh, false },
+        { "WGHT"_m, "WGHT", ChunkCategory::SourceMesh, false },
+        { "NRML"_m, "NRML", ChunkCategory::SourceMesh, false },
+        { "UV0L"_m, "UV0L", ChunkCategory::SourceMesh, false },
+        { "NDXL"_m, "NDXL", ChunkCategory::SourceMesh, false },
+        { "NDXT"_m, "NDXT", ChunkCategory::SourceMesh, false },
+        { "STRP"_m, "STRP", ChunkCategory::SourceMesh, false },
+        { "CLTH"_m, "CLTH", ChunkCategory::SourceMesh, true },
+        { "CPOS"_m, "CPOS", ChunkCategory::SourceMesh, false },
+        { "CUV0"_m, "CUV0", ChunkCategory::SourceMesh, false },
+        { "FIDX"_m, "FIDX", ChunkCategory::SourceMesh, false },
+        { "FWGT"_m, "FWGT", ChunkCategory::SourceMesh, false },
+        { "CMSH"_m, "CMSH", ChunkCategory::SourceMesh, false },
+        { "SPRS"_m, "SPRS", ChunkCategory::SourceMesh, false },
+        { "CPRS"_m, "CPRS", ChunkCategory::SourceMesh, false },
+        { "BPRS"_m, "BPRS", ChunkCategory::SourceMesh, false },
+        { "COLL"_m, "COLL", ChunkCategory::SourceMesh, false },
+        { "ENVL"_m, "ENVL", ChunkCategory::SourceMesh, false },
+        { "SWCI"_m, "SWCI", ChunkCategory::SourceMesh, false },
+        { "BLN2"_m, "BLN2", ChunkCategory::SourceMesh, true },
+        { "SKL2"_m, "SKL2", ChunkCategory::SourceMesh, true },
+        { "ANM2"_m, "ANM2", ChunkCategory::SourceMesh, true },
+        { "CYCL"_m, "CYCL", ChunkCategory::SourceMesh, false },
+        { "KFR3"_m, "KFR3", ChunkCategory::SourceMesh, false },
+        { "CL1L"_m, "CL1L", ChunkCategory::SourceMesh, false },
+        { "TERR"_m, "TERR", ChunkCategory::Terrain, false },
+        { "LVL_"_m, "LVL_", ChunkCategory::Texture, true },
+        { "lvl_"_m, "lvl_", ChunkCategory::Container, true },
+        { "ucfb"_m, "ucfb", ChunkCategory::Container, true },
+        { "mcfg"_m, "mcfg", ChunkCategory::Config, true },
+        { "INFO"_m, "INFO", ChunkCategory::Field, false },
+        { "BODY"_m, "BODY", ChunkCategory::Field, false },
+        { "SCOP"_m, "SCOP", ChunkCategory::Field, true },
+        { "XFRM"_m, "XFRM", ChunkCategory::Field, false },
+        { "VRTX"_m, "VRTX", ChunkCategory::Model, false },
+        { "SKY_"_m, "SKY_", ChunkCategory::World, false },
+        { "RTYP"_m, "RTYP", ChunkCategory::Model, false },
+        { "TNAM"_m, "TNAM", ChunkCategory::Model, false },
+        { "VBUF"_m, "VBUF", ChunkCategory::Model, false },
+        { "IBUF"_m, "IBUF", ChunkCategory::Model, false },
+        { "DXT1"_m, "DXT1", ChunkCategory::Texture, false },
+        { "DXT3"_m, "DXT3", ChunkCategory::Texture, false },
+        { "MTRL"_m, "MTRL", ChunkCategory::Model, false },
+        { "PROP"_m, "PROP", ChunkCategory::Field, false },
+        { "BNAM"_m, "BNAM", ChunkCategory::Model, false },
+        { "NODE"_m, "NODE", ChunkCategory::Field, false },
+        { "LEAF"_m, "LEAF", ChunkCategory::Field, false },
+        { "GSHD"_m, "GSHD", ChunkCategory::Model, false },
+        { "LOWD"_m, "LOWD", ChunkCategory::Model, false },
+        { "BASE"_m, "BASE", ChunkCategory::Field, false },
+        { "TYPE"_m, "TYPE", ChunkCategory::Field, false },
+        { "SPHR"_m, "SPHR", ChunkCategory::Field, false },
+        { "ARCS"_m, "ARCS", ChunkCategory::World, false },
+        { "path"_m, "path", ChunkCategory::World, true },
+        { "port"_m, "port", ChunkCategory::World, true },
+        { "comb"_m, "comb", ChunkCategory::Config, true },
+        { "sanm"_m, "sanm", ChunkCategory::Config, true },
+        { "hud_"_m, "hud_", ChunkCategory::Interface, true },
+        { "gmod"_m, "gmod", ChunkCategory::Config, true },
+        { "plnp"_m, "plnp", ChunkCategory::World, false },
+        { "SHDV"_m, "SHDV", ChunkCategory::Terrain, false },
+        { "SHDI"_m, "SHDI", ChunkCategory::Terrain, false },
+        { "LPTC"_m, "LPTC", ChunkCategory::Terrain, false },
+        { "LUMI"_m, "LUMI", ChunkCategory::Terrain, false },
+        { "PCHS"_m, "PCHS", ChunkCategory::Terrain, true },
+        { "PTCH"_m, "PTCH", ChunkCategory::Terrain, true },
+        { "FLAG"_m, "FLAG", ChunkCategory::Field, false },
+        { "MASK"_m, "MASK", ChunkCategory::Field, false },
+        { "ROTN"_m, "ROTN", ChunkCategory::Field, false },
+        { "COMN"_m, "COMN", ChunkCategory::Terrain, false },
+        { "HEXP"_m, "HEXP", ChunkCategory::Terrain, false },
+        { "HGT8"_m, "HGT8", ChunkCategory::Terrain, false },
+        { "LTEX"_m, "LTEX", ChunkCategory::Terrain, false },
+        { "SCAL"_m, "SCAL", ChunkCategory::Field, false },
+        { "AXIS"_m, "AXIS", ChunkCategory::Field, false },
+        { "SNAM"_m, "SNAM", ChunkCategory::World, false },
+        { "BARR"_m, "BARR", ChunkCategory::World, true },
+        { "DTEX"_m, "DTEX", ChunkCategory::Terrain, false },
+        { "DTLX"_m, "DTLX", ChunkCategory::Terrain, false },
+        { "PLNS"_m, "PLNS", ChunkCategory::Terrain, false },
+        { "CUTR"_m, "CUTR", ChunkCategory::Terrain, false },
+        { "FOLG"_m, "FOLG", ChunkCategory::Terrain, false },
+        { "SIZE"_m, "SIZE", ChunkCategory::Field, false },
+        { "CUTS"_m, "CUTS", ChunkCategory::Terrain, false },
+        { "POSI"_m, "POSI", ChunkCategory::Field, false },
+        { "CSHD"_m, "CSHD", ChunkCategory::Terrain, false },
+        { "TREE"_m, "TREE", ChunkCategory::Model, false },
+        { "LOWR"_m, "LOWR", ChunkCategory::Terrain, false },
+        { "DCAL"_m, "DCAL", ChunkCategory::Terrain, false },
+        { "tex_"_m, "tex_", ChunkCategory::Texture, true },
+        { "FMT_"_m, "FMT_", ChunkCategory::Texture, true },
+        { "FACE"_m, "FACE", ChunkCategory::Texture, true },
+        { "wpnc"_m, "wpnc", ChunkCategory::Entity, true },
+        { "entc"_m, "entc", ChunkCategory::Entity, true },
+        { "ordc"_m, "ordc", ChunkCategory::Entity, true },
+        { "expc"_m, "expc", ChunkCategory::Entity, true },
+        { "fx__"_m, "fx__", ChunkCategory::Effect, true },
+        { "wrld"_m, "wrld", ChunkCategory::World, true },
+        { "sky_"_m, "sky_", ChunkCategory::World, true },
+        { "bnd_"_m, "bnd_", ChunkCategory::World, true },
+        { "lght"_m, "lght", ChunkCategory::World, true },
+        { "plan"_m, "plan", ChunkCategory::World, true },
+        { "PATH"_m, "PATH", ChunkCategory::World, true },
+        { "tern"_m, "tern", ChunkCategory::Terrain, true },
+        { "modl"_m, "modl", ChunkCategory::Model, true },
+        { "segm"_m, "segm", ChunkCategory::Model, true },
+        { "skel"_m, "skel", ChunkCategory::Model, true },
+        { "coll"_m, "coll", ChunkCategory::Model, true },
+        { "prim"_m, "prim", ChunkCategory::Model, true },
+        { "Locl"_m, "Locl", ChunkCategory::Localization, true },
+        { "scr_"_m, "scr_", ChunkCategory::Script, true },
+        { "SHDR"_m, "SHDR", ChunkCategory::Shader, true },
+        { "LOD0"_m, "LOD0", ChunkCategory::Model, false },
+        { "font"_m, "font", ChunkCategory::Interface, true },
+        { "zaa_"_m, "zaa_", ChunkCategory::Animation, true },
+        { "zaf_"_m, "zaf_", ChunkCategory::Animation, true },
+        { "prp_"_m, "prp_", ChunkCategory::World, true },
+        { "regn"_m, "regn", ChunkCategory::World, true },
+        { "GRGR"_m, "GRGR", ChunkCategory::Terrain, false },
+        { "shdw"_m, "shdw", ChunkCategory::Model, true },
+        { "Hint"_m, "Hint", ChunkCategory::World, true },
+        { "inst"_m, "inst", ChunkCategory::World, true },
+        { "BIN_"_m, "BIN_", ChunkCategory::Animation, true },
+        { "FFAZ"_m, "FFAZ", ChunkCategory::Animation, true },
+        { "SREV"_m, "SREV", ChunkCategory::Animation, false },
+        { "EZIS"_m, "EZIS", ChunkCategory::Animation, false },
+        { "SLTM"_m, "SLTM", ChunkCategory::Animation, true },
+        { "LTAM"_m, "LTAM", ChunkCategory::Animation, false },
+        { "STSJ"_m, "STSJ", ChunkCategory::Animation, true },
+        { "SNKS"_m, "SNKS", ChunkCategory::Animation, true },
+        { "NIKS"_m, "NIKS", ChunkCategory::Animation, false },
+        { "LEKS"_m, "LEKS", ChunkCategory::Animation, false },
+        { "TNOJ"_m, "TNOJ", ChunkCategory::Animation, false },
+        { "SYXP"_m, "SYXP", ChunkCategory::Animation, false },
+        { "SDHS"_m, "SDHS", ChunkCategory::Animation, false },
+        { "SMNA"_m, "SMNA", ChunkCategory::Animation, true },
+        { "MINA"_m, "MINA", ChunkCategory::Animation, false },
+        { "TNJA"_m, "TNJA", ChunkCategory::Animation, false },
+        { "TADA"_m, "TADA", ChunkCategory::Animation, false },
+        { "_pad"_m, "_pad", ChunkCategory::Field, false },
+        { "snd_"_m, "snd_", ChunkCategory::Config, true },
+        { "mus_"_m, "mus_", ChunkCategory::Config, true },
+        { "ffx_"_m, "ffx_", ChunkCategory::Effect, true },
+        { "tsr_"_m, "tsr_", ChunkCategory::Config, true },
 
-    const std::set<ChunkHeader> KNOWN_GENERIC_HEADERS =
-    {
-        "HEDR"_h, "SHVO"_h, "MSH2"_h, "SINF"_h, "NAME"_h, "FRAM"_h, "BBOX"_h, "CAMR"_h,
-        "DATA"_h, "MATL"_h, "MATD"_h, "ATRB"_h, "TX0D"_h, "TX1D"_h, "TX2D"_h, "TX3D"_h,
-        "MODL"_h, "MTYP"_h, "MNDX"_h, "PRNT"_h, "FLGS"_h, "TRAN"_h, "GEOM"_h, "SEGM"_h,
-        "SHDW"_h, "MATI"_h, "POSL"_h, "CLRL"_h, "CLRB"_h, "WGHT"_h, "NRML"_h, "UV0L"_h,
-        "NDXL"_h, "NDXT"_h, "STRP"_h, "CLTH"_h, "CPOS"_h, "CUV0"_h, "FIDX"_h, "FWGT"_h,
-        "CMSH"_h, "SPRS"_h, "CPRS"_h, "BPRS"_h, "COLL"_h, "ENVL"_h, "SWCI"_h, "BLN2"_h,
-        "SKL2"_h, "ANM2"_h, "CYCL"_h, "KFR3"_h, "CL1L"_h, "TERR"_h, "LVL_"_h, "lvl_"_h,
-        "ucfb"_h, "mcfg"_h, "INFO"_h, "BODY"_h, "SCOP"_h, "XFRM"_h, "VRTX"_h, "SKY_"_h,
-        "RTYP"_h, "TNAM"_h, "VBUF"_h, "IBUF"_h, "DXT1"_h, "DXT3"_h, "MTRL"_h, "PROP"_h,
-        "BNAM"_h, "NODE"_h, "LEAF"_h, "GSHD"_h, "LOWD"_h, "BASE"_h, "TYPE"_h, "SPHR"_h,
-        "ARCS"_h, "path"_h, "port"_h, "comb"_h, "sanm"_h, "hud_"_h, "gmod"_h, "plnp"_h,
-        "SHDV"_h, "SHDI"_h, "LPTC"_h, "LUMI"_h, "PCHS"_h, "PTCH"_h, "FLAG"_h, "MASK"_h,
-        "ROTN"_h, "COMN"_h, "HEXP"_h, "HGT8"_h, "LTEX"_h, "SCAL"_h, "AXIS"_h, "SNAM"_h,
-        "BARR"_h, "DTEX"_h, "DTLX"_h, "PLNS"_h, "CUTR"_h, "FOLG"_h, "SIZE"_h, "CUTS"_h,
-        "POSI"_h, "CSHD"_h, "TREE"_h, "LOWR"_h, "DCAL"_h, "tex_"_h, "FMT_"_h, "FACE"_h,
-        "wpnc"_h, "entc"_h, "ordc"_h, "expc"_h, "fx__"_h, "wrld"_h, "sky_"_h, "bnd_"_h,
-        "lght"_h, "plan"_h, "PATH"_h, "tern"_h, "modl"_h, "segm"_h, "skel"_h, "coll"_h,
-        "prim"_h, "Locl"_h, "scr_"_h, "SHDR"_h, "LOD0"_h, "font"_h, "zaa_"_h, "zaf_"_h,
-        "prp_"_h, "bnd_"_h, "regn"_h, "BARR"_h, "GRGR"_h, "shdw"_h, "Hint"_h, "inst"_h,
-        "BIN_"_h, "FFAZ"_h, "SREV"_h, "EZIS"_h, "SLTM"_h, "LTAM"_h, "STSJ"_h, "SNKS"_h,
-        "NIKS"_h, "LEKS"_h, "TNOJ"_h, "SYXP"_h, "SDHS"_h, "SMNA"_h, "MINA"_h, "TNJA"_h,
-        "TADA"_h, "_pad"_h, "snd_"_h, "mus_"_h, "ffx_"_h, "tsr_"_h,
-    };
+        // sound banks name their chunks with FNV hashes instead of four characters
+        { "StreamList"_fnv, "StreamList", ChunkCategory::Sound, true },
+        { "Stream"_fnv, "Stream", ChunkCategory::Sound, true },
+        { "Info"_fnv, "Info", ChunkCategory::Sound, false },
+        { "SoundBankList"_fnv, "SoundBankList", ChunkCategory::Sound, true },
+        { "Data"_fnv, "Data", ChunkCategory::Sound, false },
+        { "SampleBank"_fnv, "SampleBank", ChunkCategory::Sound, true },
+    }) };
+
+    static_assert(std::ranges::all_of(KNOWN_HEADERS.GetEntries(), [](const ChunkHeaderInfo &info) { return info.m_name.size() < ChunkHeader::FORMATTED_SIZE; }),
+                  "known header names must fit ChunkHeader::Format's buffer");
 
     bool ChunkHeader::operator==(const ChunkHeader &other) const
     {
@@ -64,25 +216,31 @@ namespace SWBF2
         return m_Magic > other.m_Magic;
     }
 
-    std::string ChunkHeader::ToString() const
+    const char *ChunkHeader::Format(char (&buffer)[FORMATTED_SIZE]) const
     {
-        auto soundLookup = KNOWN_SOUND_HEADERS.find(*this);
-        if (soundLookup != KNOWN_SOUND_HEADERS.end())
+        const ChunkHeaderInfo *info = KNOWN_HEADERS.Find(m_Magic);
+        if (info != nullptr && info->m_category == ChunkCategory::Sound)
         {
-            return soundLookup->second;
+            *std::ranges::copy(info->m_name, buffer).out = '\0';
         }
-
-        std::string result;
-        if (!IsPrintableHeader(*this))
+        else if (!IsPrintableHeader(*this))
         {
-            result = std::format("0x{0:x}", m_Magic);
+            buffer[0] = '0';
+            buffer[1] = 'x';
+            *std::to_chars(buffer + 2, buffer + FORMATTED_SIZE - 1, m_Magic, 16).ptr = '\0';
         }
         else
         {
-            result = std::string(m_Name, 4);
+            *std::ranges::copy(m_Name, buffer).out = '\0';
         }
 
-        return result;
+        return buffer;
+    }
+
+    std::string ChunkHeader::ToString() const
+    {
+        char buffer[FORMATTED_SIZE];
+        return Format(buffer);
     }
 
     bool IsPrintableHeader(const ChunkHeader &hedr)
@@ -105,6 +263,11 @@ namespace SWBF2
 
     bool IsKnownHeader(const ChunkHeader &hedr)
     {
-        return (KNOWN_GENERIC_HEADERS.find(hedr) != KNOWN_GENERIC_HEADERS.end()) || (KNOWN_SOUND_HEADERS.find(hedr) != KNOWN_SOUND_HEADERS.end());
+        return KNOWN_HEADERS.Contains(hedr.m_Magic);
+    }
+
+    const ChunkHeaderInfo *GetHeaderInfo(const ChunkHeader &hedr)
+    {
+        return KNOWN_HEADERS.Find(hedr.m_Magic);
     }
 }
@@ -2,6 +2,9 @@
 
 #include <stdint.h>
 
+#include <format>
+#include <string_view>
+
 #include "../Types.hpp"
 #include "Hashing.hpp"
 
@@ -17,6 +20,11 @@ namespace SWBF2
 
         uint32_t size = 0;
 
+        static constexpr std::size_t FORMATTED_SIZE = 16;
+
+        // Writes the printable name into buffer without allocating, returns buffer
+        const char *Format(char (&buffer)[FORMATTED_SIZE]) const;
+
         std::string ToString() const;
         bool operator==(const ChunkHeader &other) const;
         bool operator!=(const ChunkHeader &other) const;
@@ -47,6 +55,46 @@ namespace SWBF2
         return *((ChunkHeader *)&fnvHeader);
     }
 
+    enum class ChunkCategory : uint8_t {
+        Container,
+        Field,
+        SourceMesh,
+        Model,
+        Texture,
+        Terrain,
+        World,
+        Entity,
+        Animation,
+        Shader,
+        Effect,
+        Interface,
+        Script,
+        Localization,
+        Config,
+        Sound,
+    };
+
+    struct ChunkHeaderInfo
+    {
+        uint32_t m_magic;
+        std::string_view m_name;
+        ChunkCategory m_category;
+        bool m_hasChildren;
+    };
+
     bool IsPrintableHeader(const ChunkHeader &hedr);
     bool IsKnownHeader(const ChunkHeader &hedr);
+
+    // nullptr for headers we have never seen in a file
+    const ChunkHeaderInfo *GetHeaderInfo(const ChunkHeader &hedr);
 }
+
+template <>
+struct std::formatter<SWBF2::ChunkHeader> : std::formatter<std::string_view> {
+    template <typename FormatContext>
+    auto format(const SWBF2::ChunkHeader &header, FormatContext &ctx) const
+    {
+        char buffer[SWBF2::ChunkHeader::FORMATTED_SIZE];
+        return std::formatter<std::string_view>::format(header.Format(buffer), ctx);
+    }
+};
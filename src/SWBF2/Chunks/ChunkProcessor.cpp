@@ -1,18 +1,24 @@
-#include <godot_cpp/variant/utility_functions.hpp>
-
 #include "ChunkProcessor.hpp"
+#include "ChunkProfiler.hpp"
+
+#include "../Logging.hpp"
 
 namespace SWBF2
 {
     void ChunkProcessor::ProcessChunk(StreamReader &streamReader, StreamReader &parentReader)
     {
-        if (!m_functions.contains(streamReader.GetHeader().m_Magic))
+        // chunk boundary, a cancelled load stops here and unwinds its readers
+        Executor::GetCurrentContext().m_token.ThrowIfCancelled();
+
+        ChunkProfileScope profile{ streamReader };
+
+        const auto *processor = Find(streamReader.GetHeader().m_Magic);
+        if (processor == nullptr)
         {
-            godot::UtilityFunctions::printerr(__FILE__, ":", __LINE__, ": No processing function for ", streamReader.GetHeader().ToString().c_str(), ", keep reading...");
+            Logging::CountUnhandledChunk(streamReader.GetSource(), streamReader.GetHeader().m_Magic);
             return;
         }
 
-        const auto &processor = m_functions.at(streamReader.GetHeader().m_Magic);
-        processor(streamReader);
+        processor->m_function(streamReader);
     }
 }
@@ -2,27 +2,57 @@
 
 #include "../Types.hpp"
 
+#include "ChunkDispatchTable.hpp"
 #include "ChunkHeader.hpp"
+#include "ChunkProfiler.hpp"
 #include "StreamReader.hpp"
 
+#include "../Threading/LoadGraph.hpp"
+
+#include "EntityClassChunk.hpp"
 #include "ModelChunk.hpp"
 #include "UcfbChunk.hpp"
 #include "WorldChunk.hpp"
 
 namespace SWBF2
 {
-    using ChunkProcessingFunction = std::function<void(StreamReader &streamReader)>;
+    using ChunkProcessingFunction = void (*)(StreamReader &streamReader);
+
+    typedef struct _CHUNK_PROCESSOR_INFO
+    {
+        uint32_t m_magic;
+        ChunkProcessingFunction m_function;
+        LoadResource m_produces;
+        LoadResource m_consumes;
+    } ChunkProcessorInfo;
 
     class ChunkProcessor {
     public:
-        static inline const std::unordered_map<uint32_t, ChunkProcessingFunction> m_functions
-        {
-            { "ucfb"_m, UcfbChunk::ProcessChunk },
-            { "wrld"_m, WorldChunk::ProcessChunk },
-            { "modl"_m, ModelChunk::ProcessChunk }
-        };
+        static constexpr ChunkDispatchTable m_functions{ std::array{
+            // a nested ucfb runs its own graph over its children
+            ChunkProcessorInfo{ "ucfb"_m, UcfbChunk::ProcessChunk, LoadResource::None, LoadResource::None },
+            // only reads names for now, nothing of the models
+            ChunkProcessorInfo{ "wrld"_m, WorldChunk::ProcessChunk, LoadResource::World, LoadResource::None },
+            ChunkProcessorInfo{ "modl"_m, ModelChunk::ProcessChunk, LoadResource::Models, LoadResource::None },
+            ChunkProcessorInfo{ "entc"_m, EntityClassChunk::ProcessChunk, LoadResource::EntityClasses, LoadResource::None },
+            ChunkProcessorInfo{ "ordc"_m, EntityClassChunk::ProcessChunk, LoadResource::EntityClasses, LoadResource::None },
+            ChunkProcessorInfo{ "wpnc"_m, EntityClassChunk::ProcessChunk, LoadResource::EntityClasses, LoadResource::None },
+            ChunkProcessorInfo{ "expc"_m, EntityClassChunk::ProcessChunk, LoadResource::EntityClasses, LoadResource::None },
+        } };
 
         static void ProcessChunk(StreamReader &streamReader, StreamReader &parentReader);
+        static constexpr const ChunkProcessorInfo *Find(uint32_t magic)
+        {
+            return m_functions.Find(magic);
+        }
+
+        // For a magic known while compiling, the call is direct and can be inlined
+        template <uint32_t Magic>
+        static void ProcessChunk(StreamReader &streamReader)
+        {
+            ChunkProfileScope profile{ streamReader };
+            GetChunkEntry<m_functions, Magic>().m_function(streamReader);
+        }
     };
 
 }
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "ChunkProfiler.hpp"
+
+namespace SWBF2
+{
+    namespace
+    {
+        // Four buckets per power of two of nanoseconds, a bucket spans at most 25% of its value
+        constexpr std::size_t SUB_BUCKET_BITS = 2;
+        constexpr std::size_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        constexpr std::size_t HISTOGRAM_BUCKETS = 64 * SUB_BUCKETS;
+
+        // Records go to one of these by thread, so threads rarely share a lock
+        constexpr std::size_t SHARDS = 16;
+
+        typedef struct _CHUNK_TYPE_STATS
+        {
+            uint64_t m_count = 0;
+            uint64_t m_bytes = 0;
+            uint64_t m_totalNanoseconds = 0;
+            uint64_t m_maxNanoseconds = 0;
+            std::array<uint32_t, HISTOGRAM_BUCKETS> m_histogram{};
+        } ChunkTypeStats;
+
+        typedef struct _PROFILER_SHARD
+        {
+            std::mutex m_mutex;
+            std::map<std::string, std::map<uint32_t, ChunkTypeStats>, std::less<>> m_files;
+        } ProfilerShard;
+
+        std::array<ProfilerShard, SHARDS> &GetShards()
+        {
+            static std::array<ProfilerShard, SHARDS> shards;
+            return shards;
+        }
+
+        std::size_t GetBucket(uint64_t nanoseconds)
+        {
+            if (nanoseconds < SUB_BUCKETS)
+            {
+                return nanoseconds;
+            }
+
+            const std::size_t msb = std::bit_width(nanoseconds) - 1;
+            const std::size_t sub = (nanoseconds >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+            return msb * SUB_BUCKETS + sub;
+        }
+
+        uint64_t GetBucketUpperBound(std::size_t bucket)
+        {
+            const std::size_t msb = bucket / SUB_BUCKETS;
+            if (msb < SUB_BUCKET_BITS)
+            {
+                return bucket;
+            }
+
+            const uint64_t sub = bucket % SUB_BUCKETS;
+            return ((SUB_BUCKETS + sub + 1) << (msb - SUB_BUCKET_BITS)) - 1;
+        }
+
+        uint64_t GetPercentile(const ChunkTypeStats &stats, double percentile)
+        {
+            const auto target = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(stats.m_count * percentile)), 1);
+
+            uint64_t seen = 0;
+            for (std::size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+            {
+                seen += stats.m_histogram[i];
+                if (seen >= target)
+                {
+                    return std::min(GetBucketUpperBound(i), stats.m_maxNanoseconds);
+                }
+            }
+
+            return stats.m_maxNanoseconds;
+        }
+
+        void Merge(ChunkTypeStats &into, const ChunkTypeStats &from)
+        {
+            into.m_count += from.m_count;
+            into.m_bytes += from.m_bytes;
+            into.m_totalNanoseconds += from.m_totalNanoseconds;
+            into.m_maxNanoseconds = std::max(into.m_maxNanoseconds, from.m_maxNanoseconds);
+
+            for (std::size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+            {
+                into.m_histogram[i] += from.m_histogram[i];
+            }
+        }
+
+        double ToMilliseconds(uint64_t nanoseconds)
+        {
+            return nanoseconds / 1'000'000.0;
+        }
+
+        thread_local ChunkProfileScope *t_currentScope = nullptr;
+    }
+
+    void ChunkProfiler::SetEnabled(bool enabled)
+    {
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    void ChunkProfiler::Record(std::string_view filename, uint32_t magic, std::size_t bytes, std::chrono::nanoseconds duration)
+    {
+        const auto nanoseconds = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+
+        auto &shard = GetShards()[std::hash<std::thread::id>{}(std::this_thread::get_id()) % SHARDS];
+        std::lock_guard lock{ shard.m_mutex };
+
+        auto file = shard.m_files.find(filename);
+        if (file == shard.m_files.end())
+        {
+            file = shard.m_files.emplace(std::string(filename), std::map<uint32_t, ChunkTypeStats>{}).first;
+        }
+
+        auto &stats = file->second[magic];
+        ++stats.m_count;
+        stats.m_bytes += bytes;
+        stats.m_totalNanoseconds += nanoseconds;
+        stats.m_maxNanoseconds = std::max(stats.m_maxNanoseconds, nanoseconds);
+        ++stats.m_histogram[GetBucket(nanoseconds)];
+    }
+
+    std::vector<ChunkProfile> ChunkProfiler::GetProfiles()
+    {
+        std::map<std::string, std::map<uint32_t, ChunkTypeStats>> merged;
+
+        for (auto &shard : GetShards())
+        {
+            std::lock_guard lock{ shard.m_mutex };
+
+            for (const auto &[filename, types] : shard.m_files)
+            {
+                auto &mergedTypes = merged[filename];
+                for (const auto &[magic, stats] : types)
+                {
+                    Merge(mergedTypes[magic], stats);
+                }
+            }
+        }
+
+        std::vector<ChunkProfile> profiles;
+        for (const auto &[filename, types] : merged)
+        {
+            const auto first = profiles.size();
+
+            for (const auto &[magic, stats] : types)
+            {
+                profiles.push_back({
+                    filename,
+                    magic,
+                    stats.m_count,
+                    stats.m_bytes,
+                    ToMilliseconds(stats.m_totalNanoseconds),
+                    ToMilliseconds(GetPercentile(stats, 0.50)),
+                    ToMilliseconds(GetPercentile(stats, 0.99)),
+                    ToMilliseconds(stats.m_maxNanoseconds),
+                });
+            }
+
+            std::sort(profiles.begin() + first, profiles.end(), [](const ChunkProfile &a, const ChunkProfile &b)
+                {
+                    return a.m_totalMilliseconds > b.m_totalMilliseconds;
+                });
+        }
+
+        return profiles;
+    }
+
+    void ChunkProfiler::Reset()
+    {
+        for (auto &shard : GetShards())
+        {
+            std::lock_guard lock{ shard.m_mutex };
+            shard.m_files.clear();
+        }
+    }
+
+    void ChunkProfileScope::Begin(const StreamReader &reader)
+    {
+        m_reader = &reader;
+        m_parent = t_currentScope;
+        t_currentScope = this;
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    void ChunkProfileScope::End()
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - m_start;
+
+        t_currentScope = m_parent;
+        if (m_parent != nullptr)
+        {
+            m_parent->m_nested += elapsed;
+        }
+
+        ChunkProfiler::Record(m_reader->GetSource(), m_reader->GetHeader().m_Magic, m_reader->GetHeader().size, elapsed - m_nested);
+    }
+}
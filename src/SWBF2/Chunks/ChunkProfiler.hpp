@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include "../Types.hpp"
+
+#include "StreamReader.hpp"
+
+namespace SWBF2
+{
+    typedef struct _CHUNK_PROFILE
+    {
+        std::string m_filename;
+        uint32_t m_magic;
+        uint64_t m_count;
+        uint64_t m_bytes;
+        double m_totalMilliseconds; // self time, see ChunkProfileScope
+        double m_p50Milliseconds;   // from the histogram, within 25%
+        double m_p99Milliseconds;
+        double m_maxMilliseconds;
+    } ChunkProfile;
+
+    // Opt-in decode timings per file and chunk magic. While disabled a
+    // ChunkProfileScope costs one relaxed load.
+    class ChunkProfiler {
+    public:
+        static void SetEnabled(bool enabled);
+        static bool IsEnabled()
+        {
+            return m_enabled.load(std::memory_order_relaxed);
+        }
+
+        static void Record(std::string_view filename, uint32_t magic, std::size_t bytes, std::chrono::nanoseconds duration);
+
+        static std::vector<ChunkProfile> GetProfiles(); // by file, then most total time first
+        static void Reset();
+
+    private:
+        static inline std::atomic<bool> m_enabled{ false };
+    };
+
+    // Times the chunk of reader from construction to destruction. Scopes opened
+    // inside it on the same thread are subtracted: nested chunks have their own
+    // entries, and a chunk waiting on its tasks may run unrelated chunks meanwhile.
+    class ChunkProfileScope {
+    public:
+        explicit ChunkProfileScope(const StreamReader &reader)
+        {
+            if (ChunkProfiler::IsEnabled())
+            {
+                Begin(reader);
+            }
+        }
+
+        ~ChunkProfileScope()
+        {
+            if (m_reader != nullptr)
+            {
+                End();
+            }
+        }
+
+        ChunkProfileScope(const ChunkProfileScope &) = delete;
+        ChunkProfileScope &operator=(const ChunkProfileScope &) = delete;
+
+    private:
+        void Begin(const StreamReader &reader);
+        void End();
+
+        const StreamReader *m_reader = nullptr;
+        ChunkProfileScope *m_parent = nullptr;
+        std::chrono::steady_clock::time_point m_start;
+        std::chrono::nanoseconds m_nested{ 0 };
+    };
+}
@@ -0,0 +1,66 @@
+#include "StreamReader.hpp"
+
+#include "EntityClassChunk.hpp"
+
+#include "../EntityClasses.hpp"
+#include "../Logging.hpp"
+
+namespace SWBF2
+{
+    void EntityClassChunk::ProcessChunk(StreamReader &streamReader)
+    {
+        EntityClass entityClass;
+        entityClass.m_level = streamReader.GetSource();
+
+        switch (streamReader.GetHeader().m_Magic)
+        {
+            case "ordc"_m:
+                entityClass.m_type = EntityClassType::Ordnance;
+                break;
+            case "wpnc"_m:
+                entityClass.m_type = EntityClassType::Weapon;
+                break;
+            case "expc"_m:
+                entityClass.m_type = EntityClassType::Explosion;
+                break;
+            default:
+                entityClass.m_type = EntityClassType::GameObject;
+                break;
+        }
+
+        std::optional<StreamReader> readerChild;
+        while ((readerChild = streamReader.ReadChild()).has_value())
+        {
+            switch (readerChild->GetHeader().m_Magic)
+            {
+                case "BASE"_m:
+                    entityClass.m_base = readerChild->ReadStringView();
+                    break;
+
+                case "TYPE"_m:
+                    entityClass.m_name = readerChild->ReadStringView();
+                    break;
+
+                case "PROP"_m: {
+                    FNVHash key;
+                    *readerChild >> key;
+
+                    entityClass.m_properties.Set(key, readerChild->ReadStringView());
+                    break;
+                }
+
+                default:
+                    Logging::CountUnhandledChunk(streamReader.GetSource(), readerChild->GetHeader().m_Magic);
+                    break;
+            }
+        }
+
+        if (entityClass.m_name.empty())
+        {
+            SWBF2_LOG(LogLevel::Warning, __FILE__, ":", __LINE__, ": class without TYPE at ", static_cast<int64_t>(streamReader.GetOffset()), " of ", entityClass.m_level.c_str());
+            return;
+        }
+
+        EntityClasses::Insert(std::move(entityClass));
+    }
+}
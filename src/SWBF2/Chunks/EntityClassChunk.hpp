@@ -0,0 +1,12 @@
+#pragma once
+
+#include "StreamReader.hpp"
+
+namespace SWBF2
+{
+    // entc, ordc, wpnc and expc: a BASE and TYPE name, then a PROP per ODF line
+    class EntityClassChunk {
+    public:
+        static void ProcessChunk(StreamReader &streamReader);
+    };
+}
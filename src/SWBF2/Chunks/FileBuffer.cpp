@@ -0,0 +1,185 @@
+
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "FileBuffer.hpp"
+
+#include "../MemoryAccounting.hpp"
+
+namespace SWBF2
+{
+    std::shared_ptr<const FileBuffer> FileBuffer::Map(const std::string &filename)
+    {
+        std::shared_ptr<FileBuffer> buffer{ new FileBuffer() };
+        buffer->m_filename = filename;
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return nullptr;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        buffer->m_file = file;
+        buffer->m_mapping = mapping;
+        buffer->m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            close(fd);
+            return nullptr;
+        }
+
+        void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (data == MAP_FAILED)
+        {
+            return nullptr;
+        }
+
+        buffer->m_size = static_cast<std::size_t>(st.st_size);
+#endif
+
+        buffer->m_data = static_cast<const std::byte *>(data);
+        buffer->m_mapped = true;
+
+        MemoryAccounting::OnBufferAllocated(filename, buffer->m_size);
+
+        return buffer;
+    }
+
+    std::shared_ptr<const FileBuffer> FileBuffer::Open(const std::string &filename)
+    {
+        auto buffer = Map(filename);
+        if (!buffer)
+        {
+            buffer = Read(filename);
+        }
+
+        return buffer;
+    }
+
+    std::shared_ptr<const FileBuffer> FileBuffer::Read(const std::string &filename, std::size_t offset, std::size_t size)
+    {
+        std::ifstream is{ filename, std::ios::binary | std::ios::ate };
+        if (!is.is_open())
+        {
+            return nullptr;
+        }
+
+        const std::size_t fileSize = is.tellg();
+        if (offset >= fileSize)
+        {
+            return nullptr;
+        }
+
+        size = std::min(size, fileSize - offset);
+
+        std::shared_ptr<FileBuffer> buffer{ new FileBuffer() };
+        buffer->m_filename = filename;
+        buffer->m_offset = offset;
+        buffer->m_heap.resize(size);
+
+        is.seekg(offset, std::ios::beg);
+        is.read(reinterpret_cast<char *>(&buffer->m_heap[0]), size);
+        if (!is)
+        {
+            return nullptr;
+        }
+
+        buffer->m_data = buffer->m_heap.data();
+        buffer->m_size = size;
+
+        MemoryAccounting::OnBufferAllocated(filename, buffer->m_size);
+
+        return buffer;
+    }
+
+    FileBuffer::~FileBuffer()
+    {
+        if (m_data == nullptr)
+        {
+            return;
+        }
+
+        MemoryAccounting::OnBufferReleased(m_filename, m_size);
+
+        if (!m_mapped)
+        {
+            return;
+        }
+
+#ifdef _WIN32
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping);
+        CloseHandle(m_file);
+#else
+        munmap(const_cast<std::byte *>(m_data), m_size);
+#endif
+    }
+
+    const std::byte *FileBuffer::GetData() const
+    {
+        return m_data;
+    }
+
+    std::size_t FileBuffer::GetSize() const
+    {
+        return m_size;
+    }
+
+    std::size_t FileBuffer::GetOffset() const
+    {
+        return m_offset;
+    }
+
+    const std::string &FileBuffer::GetFilename() const
+    {
+        return m_filename;
+    }
+
+    bool FileBuffer::IsMapped() const
+    {
+        return m_mapped;
+    }
+}
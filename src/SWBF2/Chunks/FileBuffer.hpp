@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+
+#include "../Types.hpp"
+
+namespace SWBF2
+{
+    // Refcounted bytes of an lvl file, either memory-mapped or read to the heap.
+    // StreamReaders keep the buffer alive, so chunks can be decoded after
+    // ReadUcfbFile has returned.
+    class FileBuffer {
+    public:
+        static std::shared_ptr<const FileBuffer> Map(const std::string &filename);
+        static std::shared_ptr<const FileBuffer> Read(const std::string &filename, std::size_t offset = 0, std::size_t size = SIZE_MAX);
+        static std::shared_ptr<const FileBuffer> Open(const std::string &filename); // Map, or Read where mapping fails
+
+        FileBuffer(const FileBuffer &) = delete;
+        FileBuffer &operator=(const FileBuffer &) = delete;
+        ~FileBuffer();
+
+        const std::byte *GetData() const;
+        std::size_t GetSize() const;
+        std::size_t GetOffset() const; // offset of the first byte in the file
+        const std::string &GetFilename() const;
+        bool IsMapped() const;
+
+    private:
+        FileBuffer() = default;
+
+        std::string m_filename;
+        const std::byte *m_data = nullptr;
+        std::size_t m_size = 0;
+        std::size_t m_offset = 0;
+
+        std::vector<std::byte> m_heap;
+
+        bool m_mapped = false;
+#ifdef _WIN32
+        void *m_file = nullptr;
+        void *m_mapping = nullptr;
+#endif
+    };
+}
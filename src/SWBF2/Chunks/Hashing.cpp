@@ -1,29 +1,256 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <utility>
 
-#include "Hashing.h"
-#include "SWBF2.h"
+#include "FileBuffer.hpp"
+#include "Hashing.hpp"
 
-#include <fstream>
+#include "../Logging.hpp"
 
-namespace LibSWBF2
+namespace SWBF2
 {
-#ifdef LOOKUP_CSV_PATH
-    std::unordered_map<FNVHash, std::string> *FNV::p_LookupTable = nullptr;
-#endif // LOOKUP_CSV_PATH
+    namespace
+    {
+        typedef struct _LOOKUP_TABLE
+        {
+            std::shared_ptr<const FileBuffer> m_buffer;
+            std::span<const FNVDictionaryEntry> m_entries;
+            std::string_view m_strings; // ends with a NUL
+        } LookupTable;
+
+        // Lookups take their own reference, so a replaced or closed table is
+        // unmapped once the last lookup reading it returned
+        std::mutex s_lookupMutex;
+        std::shared_ptr<const LookupTable> s_lookupTable;
+
+        std::shared_ptr<const LookupTable> GetLookupTable()
+        {
+            std::lock_guard lock{ s_lookupMutex };
+            return s_lookupTable;
+        }
+
+        constexpr uint32_t FNV_PRIME = 16777619;
+        constexpr uint32_t FNV_OFFSET_BASIS = 2166136261;
+
+        // HashBatch orders this many strings at a time, longer ones share the last length
+        constexpr std::size_t BATCH_WINDOW = 256;
+        constexpr std::size_t MAX_ORDERED_LENGTH = 64;
+
+        // One byte of every lane. Unrolled so the lane states stay in registers
+        // and the lanes' multiplies overlap instead of waiting on each other.
+        template <std::size_t... Lane>
+        void HashLanes(std::array<uint32_t, sizeof...(Lane)> &lanes, const std::array<const char *, sizeof...(Lane)> &heads, std::size_t i, std::index_sequence<Lane...>)
+        {
+            ((lanes[Lane] = (lanes[Lane] ^ static_cast<uint32_t>(static_cast<char>(heads[Lane][i] | 0x20))) * FNV_PRIME), ...);
+        }
+    }
+
+    namespace
+    {
+        // MSB first CRC-32, polynomial 0x04C11DB7
+        constexpr std::array<uint32_t, 256> CRC_TABLE =
+        {
+            0x00000000, 0x04C11DB7, 0x09823B6E, 0x0D4326D9,
+            0x130476DC, 0x17C56B6B, 0x1A864DB2, 0x1E475005,
+            0x2608EDB8, 0x22C9F00F, 0x2F8AD6D6, 0x2B4BCB61,
+            0x350C9B64, 0x31CD86D3, 0x3C8EA00A, 0x384FBDBD,
+            0x4C11DB70, 0x48D0C6C7, 0x4593E01E, 0x4152FDA9,
+            0x5F15ADAC, 0x5BD4B01B, 0x569796C2, 0x52568B75,
+            0x6A1936C8, 0x6ED82B7F, 0x639B0DA6, 0x675A1011,
+            0x791D4014, 0x7DDC5DA3, 0x709F7B7A, 0x745E66CD,
+            0x9823B6E0, 0x9CE2AB57, 0x91A18D8E, 0x95609039,
+            0x8B27C03C, 0x8FE6DD8B, 0x82A5FB52, 0x8664E6E5,
+            0xBE2B5B58, 0xBAEA46EF, 0xB7A96036, 0xB3687D81,
+            0xAD2F2D84, 0xA9EE3033, 0xA4AD16EA, 0xA06C0B5D,
+            0xD4326D90, 0xD0F37027, 0xDDB056FE, 0xD9714B49,
+            0xC7361B4C, 0xC3F706FB, 0xCEB42022, 0xCA753D95,
+            0xF23A8028, 0xF6FB9D9F, 0xFBB8BB46, 0xFF79A6F1,
+            0xE13EF6F4, 0xE5FFEB43, 0xE8BCCD9A, 0xEC7DD02D,
+            0x34867077, 0x30476DC0, 0x3D044B19, 0x39C556AE,
+            0x278206AB, 0x23431B1C, 0x2E003DC5, 0x2AC12072,
+            0x128E9DCF, 0x164F8078, 0x1B0CA6A1, 0x1FCDBB16,
+            0x018AEB13, 0x054BF6A4, 0x0808D07D, 0x0CC9CDCA,
+            0x7897AB07, 0x7C56B6B0, 0x71159069, 0x75D48DDE,
+            0x6B93DDDB, 0x6F52C06C, 0x6211E6B5, 0x66D0FB02,
+            0x5E9F46BF, 0x5A5E5B08, 0x571D7DD1, 0x53DC6066,
+            0x4D9B3063, 0x495A2DD4, 0x44190B0D, 0x40D816BA,
+            0xACA5C697, 0xA864DB20, 0xA527FDF9, 0xA1E6E04E,
+            0xBFA1B04B, 0xBB60ADFC, 0xB6238B25, 0xB2E29692,
+            0x8AAD2B2F, 0x8E6C3698, 0x832F1041, 0x87EE0DF6,
+            0x99A95DF3, 0x9D684044, 0x902B669D, 0x94EA7B2A,
+            0xE0B41DE7, 0xE4750050, 0xE9362689, 0xEDF73B3E,
+            0xF3B06B3B, 0xF771768C, 0xFA325055, 0xFEF34DE2,
+            0xC6BCF05F, 0xC27DEDE8, 0xCF3ECB31, 0xCBFFD686,
+            0xD5B88683, 0xD1799B34, 0xDC3ABDED, 0xD8FBA05A,
+            0x690CE0EE, 0x6DCDFD59, 0x608EDB80, 0x644FC637,
+            0x7A089632, 0x7EC98B85, 0x738AAD5C, 0x774BB0EB,
+            0x4F040D56, 0x4BC510E1, 0x46863638, 0x42472B8F,
+            0x5C007B8A, 0x58C1663D, 0x558240E4, 0x51435D53,
+            0x251D3B9E, 0x21DC2629, 0x2C9F00F0, 0x285E1D47,
+            0x36194D42, 0x32D850F5, 0x3F9B762C, 0x3B5A6B9B,
+            0x0315D626, 0x07D4CB91, 0x0A97ED48, 0x0E56F0FF,
+            0x1011A0FA, 0x14D0BD4D, 0x19939B94, 0x1D528623,
+            0xF12F560E, 0xF5EE4BB9, 0xF8AD6D60, 0xFC6C70D7,
+            0xE22B20D2, 0xE6EA3D65, 0xEBA91BBC, 0xEF68060B,
+            0xD727BBB6, 0xD3E6A601, 0xDEA580D8, 0xDA649D6F,
+            0xC423CD6A, 0xC0E2D0DD, 0xCDA1F604, 0xC960EBB3,
+            0xBD3E8D7E, 0xB9FF90C9, 0xB4BCB610, 0xB07DABA7,
+            0xAE3AFBA2, 0xAAFBE615, 0xA7B8C0CC, 0xA379DD7B,
+            0x9B3660C6, 0x9FF77D71, 0x92B45BA8, 0x9675461F,
+            0x8832161A, 0x8CF30BAD, 0x81B02D74, 0x857130C3,
+            0x5D8A9099, 0x594B8D2E, 0x5408ABF7, 0x50C9B640,
+            0x4E8EE645, 0x4A4FFBF2, 0x470CDD2B, 0x43CDC09C,
+            0x7B827D21, 0x7F436096, 0x7200464F, 0x76C15BF8,
+            0x68860BFD, 0x6C47164A, 0x61043093, 0x65C52D24,
+            0x119B4BE9, 0x155A565E, 0x18197087, 0x1CD86D30,
+            0x029F3D35, 0x065E2082, 0x0B1D065B, 0x0FDC1BEC,
+            0x3793A651, 0x3352BBE6, 0x3E119D3F, 0x3AD08088,
+            0x2497D08D, 0x2056CD3A, 0x2D15EBE3, 0x29D4F654,
+            0xC5A92679, 0xC1683BCE, 0xCC2B1D17, 0xC8EA00A0,
+            0xD6AD50A5, 0xD26C4D12, 0xDF2F6BCB, 0xDBEE767C,
+            0xE3A1CBC1, 0xE760D676, 0xEA23F0AF, 0xEEE2ED18,
+            0xF0A5BD1D, 0xF464A0AA, 0xF9278673, 0xFDE69BC4,
+            0x89B8FD09, 0x8D79E0BE, 0x803AC667, 0x84FBDBD0,
+            0x9ABC8BD5, 0x9E7D9662, 0x933EB0BB, 0x97FFAD0C,
+            0xAFB010B1, 0xAB710D06, 0xA6322BDF, 0xA2F33668,
+            0xBCB4666D, 0xB8757BDA, 0xB5365D03, 0xB1F740B4,
+        };
+
+        // case translation table
+        constexpr std::array<uint8_t, 256> TO_LOWER =
+        {
+            0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,
+            0x08,0x09,0x0a,0x0b,0x0c,0x0d,0x0e,0x0f,
+            0x10,0x11,0x12,0x13,0x14,0x15,0x16,0x17,
+            0x18,0x19,0x1a,0x1b,0x1c,0x1d,0x1e,0x1f,
+            0x20,0x21,0x22,0x23,0x24,0x25,0x26,0x27,
+            0x28,0x29,0x2a,0x2b,0x2c,0x2d,0x2e,0x2f,
+            0x30,0x31,0x32,0x33,0x34,0x35,0x36,0x37,
+            0x38,0x39,0x3a,0x3b,0x3c,0x3d,0x3e,0x3f,
+            0x40,0x61,0x62,0x63,0x64,0x65,0x66,0x67,
+            0x68,0x69,0x6a,0x6b,0x6c,0x6d,0x6e,0x6f,
+            0x70,0x71,0x72,0x73,0x74,0x75,0x76,0x77,
+            0x78,0x79,0x7a,0x5b,0x5c,0x5d,0x5e,0x5f,
+            0x60,0x61,0x62,0x63,0x64,0x65,0x66,0x67,
+            0x68,0x69,0x6a,0x6b,0x6c,0x6d,0x6e,0x6f,
+            0x70,0x71,0x72,0x73,0x74,0x75,0x76,0x77,
+            0x78,0x79,0x7a,0x7b,0x7c,0x7d,0x7e,0x7f,
+            0x80,0x81,0x82,0x83,0x84,0x85,0x86,0x87,
+            0x88,0x89,0x8a,0x8b,0x8c,0x8d,0x8e,0x8f,
+            0x90,0x91,0x92,0x93,0x94,0x95,0x96,0x97,
+            0x98,0x99,0x9a,0x9b,0x9c,0x9d,0x9e,0x9f,
+            0xa0,0xa1,0xa2,0xa3,0xa4,0xa5,0xa6,0xa7,
+            0xa8,0xa9,0xaa,0xab,0xac,0xad,0xae,0xaf,
+            0xb0,0xb1,0xb2,0xb3,0xb4,0xb5,0xb6,0xb7,
+            0xb8,0xb9,0xba,0xbb,0xbc,0xbd,0xbe,0xbf,
+            0xc0,0xc1,0xc2,0xc3,0xc4,0xc5,0xc6,0xc7,
+            0xc8,0xc9,0xca,0xcb,0xcc,0xcd,0xce,0xcf,
+            0xd0,0xd1,0xd2,0xd3,0xd4,0xd5,0xd6,0xd7,
+            0xd8,0xd9,0xda,0xdb,0xdc,0xdd,0xde,0xdf,
+            0xe0,0xe1,0xe2,0xe3,0xe4,0xe5,0xe6,0xe7,
+            0xe8,0xe9,0xea,0xeb,0xec,0xed,0xee,0xef,
+            0xf0,0xf1,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7,
+            0xf8,0xf9,0xfa,0xfb,0xfc,0xfd,0xfe,0xff,
+        };
+
+        // Slicing-by-8: SLICES[k][b] is the CRC of byte b followed by k zero bytes.
+        // Slices 0 to 3 take bytes that are not xored into the CRC first, those
+        // have TO_LOWER folded in.
+        consteval std::array<std::array<uint32_t, 256>, 8> MakeSlices()
+        {
+            std::array<std::array<uint32_t, 256>, 8> plain{};
+            plain[0] = CRC_TABLE;
+
+            for (std::size_t k = 1; k < plain.size(); ++k)
+            {
+                for (std::size_t b = 0; b < 256; ++b)
+                {
+                    plain[k][b] = (plain[k - 1][b] << 8) ^ CRC_TABLE[plain[k - 1][b] >> 24];
+                }
+            }
+
+            auto slices = plain;
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                for (std::size_t b = 0; b < 256; ++b)
+                {
+                    slices[k][b] = plain[k][TO_LOWER[b]];
+                }
+            }
+
+            return slices;
+        }
+
+        constexpr auto SLICES = MakeSlices();
+
+        constexpr CRCChecksum CalcLowerCRCBytewise(std::string_view str)
+        {
+            CRCChecksum crc = 0xFFFFFFFF;
+            for (const char c : str)
+            {
+                crc = (crc << 8) ^ CRC_TABLE[(crc >> 24) ^ TO_LOWER[static_cast<uint8_t>(c)]];
+            }
+            return ~crc;
+        }
+
+        constexpr CRCChecksum CalcLowerCRCSliced(std::string_view str)
+        {
+            const auto byte = [&](std::size_t i)
+                {
+                    return static_cast<uint8_t>(str[i]);
+                };
+
+            CRCChecksum crc = 0xFFFFFFFF;
+
+            std::size_t i = 0;
+            for (; i + 8 <= str.size(); i += 8)
+            {
+                crc ^= (static_cast<uint32_t>(TO_LOWER[byte(i)]) << 24) |
+                       (static_cast<uint32_t>(TO_LOWER[byte(i + 1)]) << 16) |
+                       (static_cast<uint32_t>(TO_LOWER[byte(i + 2)]) << 8) |
+                       static_cast<uint32_t>(TO_LOWER[byte(i + 3)]);
+
+                crc = SLICES[7][crc >> 24] ^ SLICES[6][(crc >> 16) & 0xFF] ^ SLICES[5][(crc >> 8) & 0xFF] ^ SLICES[4][crc & 0xFF] ^
+                      SLICES[3][byte(i + 4)] ^ SLICES[2][byte(i + 5)] ^ SLICES[1][byte(i + 6)] ^ SLICES[0][byte(i + 7)];
+            }
+
+            for (; i < str.size(); ++i)
+            {
+                crc = (crc << 8) ^ CRC_TABLE[(crc >> 24) ^ TO_LOWER[byte(i)]];
+            }
+
+            return ~crc;
+        }
+
+        // The sliced CRC has to match the byte at a time one over the tables above
+        static_assert(CalcLowerCRCBytewise("") == 0);
+        static_assert(CalcLowerCRCBytewise("Hello") == 0x1931653D);
+        static_assert(CalcLowerCRCSliced("") == CalcLowerCRCBytewise(""));
+        static_assert(CalcLowerCRCSliced("a") == CalcLowerCRCBytewise("A"));
+        static_assert(CalcLowerCRCSliced("ABCDEFGH") == CalcLowerCRCBytewise("abcdefgh"));
+        static_assert(CalcLowerCRCSliced("com_weap_inf_rifle") == CalcLowerCRCBytewise("com_weap_inf_rifle"));
+        static_assert(CalcLowerCRCSliced("Level.Common.Ingame.Hud.Tickers") == CalcLowerCRCBytewise("level.common.ingame.hud.tickers"));
+        static_assert(CalcLowerCRCSliced("\x80\xC9\xE9\xFF Zz@[`{\x7F\x01 0123456789") == CalcLowerCRCBytewise("\x80\xC9\xE9\xFF zz@[`{\x7F\x01 0123456789"));
+    }
 
     CRCChecksum CRC::CalcLowerCRC(const char *str)
     {
         if (str == nullptr)
         {
-            UE_LOGFMT(LogHashing, Error, "Given string pointer was NULL!");
+            SWBF2_LOG(LogLevel::Error, __FILE__, ":", __LINE__, ": given string pointer was NULL");
             return 0;
         }
 
-        CRCChecksum crc = 0xFFFFFFFF;
-        for (const unsigned char *p = (const unsigned char *)str; *p; p++)
-        {
-            crc = (crc << 8) ^ m_Table32[(crc >> 24) ^ m_ToLower[*p]];
-        }
-        return ~crc;
+        return CalcLowerCRCSliced(str);
+    }
+
+    CRCChecksum CRC::CalcLowerCRC(std::string_view str)
+    {
+        return CalcLowerCRCSliced(str);
     }
 
     FNVHash FNV::Hash(const std::string &str)
@@ -46,156 +273,223 @@ namespace LibSWBF2
         return hash;
     }
 
+    void FNV::HashBatch(std::span<const std::string_view> strings, std::span<FNVHash> hashes)
+    {
+        const std::size_t count = std::min(strings.size(), hashes.size());
+
+        for (std::size_t window = 0; window < count; window += BATCH_WINDOW)
+        {
+            const std::size_t windowSize = std::min(BATCH_WINDOW, count - window);
+            const auto windowStrings = strings.subspan(window, windowSize);
+
+            // Counting sort of the window by length, so the strings of a batch are
+            // about as long and the lanes rarely finish alone. Windows keep the
+            // reads close together in large sets.
+            std::array<uint32_t, MAX_ORDERED_LENGTH + 2> starts{};
+            for (const auto &str : windowStrings)
+            {
+                ++starts[std::min(str.size(), MAX_ORDERED_LENGTH) + 1];
+            }
+
+            for (std::size_t i = 1; i < starts.size(); ++i)
+            {
+                starts[i] += starts[i - 1];
+            }
+
+            std::array<uint32_t, BATCH_WINDOW> order;
+            for (std::size_t i = 0; i < windowSize; ++i)
+            {
+                order[starts[std::min(windowStrings[i].size(), MAX_ORDERED_LENGTH)]++] = static_cast<uint32_t>(window + i);
+            }
+
+            std::size_t first = 0;
+            for (; first + BATCH_LANES <= windowSize; first += BATCH_LANES)
+            {
+                std::array<uint32_t, BATCH_LANES> lanes;
+                lanes.fill(FNV_OFFSET_BASIS);
+
+                // lengths past MAX_ORDERED_LENGTH are not in order
+                std::array<const char *, BATCH_LANES> heads;
+                std::size_t shortest = SIZE_MAX;
+
+                for (std::size_t lane = 0; lane < BATCH_LANES; ++lane)
+                {
+                    heads[lane] = strings[order[first + lane]].data();
+                    shortest = std::min(shortest, strings[order[first + lane]].size());
+                }
+
+                for (std::size_t i = 0; i < shortest; ++i)
+                {
+                    HashLanes(lanes, heads, i, std::make_index_sequence<BATCH_LANES>{});
+                }
+
+                for (std::size_t lane = 0; lane < BATCH_LANES; ++lane)
+                {
+                    const auto &str = strings[order[first + lane]];
+                    for (std::size_t i = shortest; i < str.size(); ++i)
+                    {
+                        char c = str[i];
+                        c |= 0x20;
+
+                        lanes[lane] ^= c;
+                        lanes[lane] *= FNV_PRIME;
+                    }
+
+                    hashes[order[first + lane]] = lanes[lane];
+                }
+            }
+
+            for (; first < windowSize; ++first)
+            {
+                hashes[order[first]] = HashConstexpr(strings[order[first]]);
+            }
+        }
+    }
+
     bool FNV::Lookup(FNVHash hash, std::string &result)
     {
-#ifdef LOOKUP_CSV_PATH
-        if (p_LookupTable == nullptr)
+        auto name = Lookup(hash);
+        if (!name)
         {
-            // This should not happen, since ReadLookupTable() is called
-            // on DLL entry. But I'll put it here anyway, just in case...
-            ReadLookupTable();
+            return false;
         }
 
-        const auto it = p_LookupTable->find(hash);
-        if (it != p_LookupTable->end())
+        result = std::move(*name);
+        return true;
+    }
+
+    std::optional<std::string> FNV::Lookup(FNVHash hash)
+    {
+        const auto table = GetLookupTable();
+        if (table == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        const auto it = std::ranges::lower_bound(table->m_entries, hash, {}, &FNVDictionaryEntry::m_hash);
+        if (it == table->m_entries.end() || it->m_hash != hash || it->m_offset >= table->m_strings.size())
         {
-            result = it->second.data();
-            return true;
+            return std::nullopt;
         }
-#endif // LOOKUP_CSV_PATH
-        return false;
+
+        // the table ends with a NUL, so the find always stops inside it
+        const auto name = table->m_strings.substr(it->m_offset);
+        return std::string{ name.substr(0, name.find('\0')) };
     }
-#ifdef LOOKUP_CSV_PATH
-    void FNV::ReadLookupTable()
+
+    bool FNV::OpenLookupTable(const std::string &filename)
     {
-        if (p_LookupTable == nullptr)
+        auto buffer = FileBuffer::Open(filename);
+        if (!buffer)
         {
-            p_LookupTable = new std::unordered_map<FNVHash, std::string>();
+            SWBF2_LOG(LogLevel::Error, __FILE__, ":", __LINE__, ": failed open ", filename.c_str(), " file");
+            return false;
         }
 
-        std::ifstream csv(LOOKUP_CSV_PATH);
-        for (std::string line; std::getline(csv, line); )
+        const auto size = buffer->GetSize();
+        const auto *data = buffer->GetData();
+
+        FNVDictionaryHeader header{};
+        if (size >= sizeof(header))
         {
-            // Exclude carriage return for Unix compatibility
-            if (!line.empty() && line.back() == 0x0D)
-            {
-                line.pop_back();
-            }
+            std::memcpy(&header, data, sizeof(header));
+        }
+
+        const auto entriesEnd = sizeof(header) + static_cast<std::size_t>(header.m_count) * sizeof(FNVDictionaryEntry);
+        if (size < sizeof(header) || header.m_magic != FNVDictionaryHeader::MAGIC || header.m_version != FNVDictionaryHeader::VERSION ||
+            header.m_stringsOffset < entriesEnd || header.m_stringsOffset >= size || data[size - 1] != std::byte{ 0 })
+        {
+            SWBF2_LOG(LogLevel::Error, __FILE__, ":", __LINE__, ": ", filename.c_str(), " is not an FNV dictionary");
+            return false;
+        }
+
+        auto table = std::make_shared<LookupTable>();
+        table->m_entries = { reinterpret_cast<const FNVDictionaryEntry *>(data + sizeof(header)), header.m_count };
+        table->m_strings = { reinterpret_cast<const char *>(data + header.m_stringsOffset), size - header.m_stringsOffset };
+        table->m_buffer = std::move(buffer);
 
-            p_LookupTable->emplace(Hash(line.c_str()), line);
+        std::shared_ptr<const LookupTable> previous; // unmapped outside the lock
+        {
+            std::lock_guard lock{ s_lookupMutex };
+            previous = std::exchange(s_lookupTable, std::move(table));
         }
+
+        return true;
     }
-    void FNV::ReleaseLookupTable()
+
+    void FNV::CloseLookupTable()
     {
-        delete p_LookupTable;
-        p_LookupTable = nullptr;
+        std::shared_ptr<const LookupTable> previous;
+        {
+            std::lock_guard lock{ s_lookupMutex };
+            previous = std::exchange(s_lookupTable, nullptr);
+        }
     }
-#endif // LOOKUP_CSV_PATH
-
 
-    // CRC table
-    uint32_t CRC::m_Table32[256] =
+    bool FNV::WriteLookupTable(const std::string &filename, const std::vector<std::string> &names)
     {
-        0x00000000, 0x04C11DB7, 0x09823B6E, 0x0D4326D9,
-        0x130476DC, 0x17C56B6B, 0x1A864DB2, 0x1E475005,
-        0x2608EDB8, 0x22C9F00F, 0x2F8AD6D6, 0x2B4BCB61,
-        0x350C9B64, 0x31CD86D3, 0x3C8EA00A, 0x384FBDBD,
-        0x4C11DB70, 0x48D0C6C7, 0x4593E01E, 0x4152FDA9,
-        0x5F15ADAC, 0x5BD4B01B, 0x569796C2, 0x52568B75,
-        0x6A1936C8, 0x6ED82B7F, 0x639B0DA6, 0x675A1011,
-        0x791D4014, 0x7DDC5DA3, 0x709F7B7A, 0x745E66CD,
-        0x9823B6E0, 0x9CE2AB57, 0x91A18D8E, 0x95609039,
-        0x8B27C03C, 0x8FE6DD8B, 0x82A5FB52, 0x8664E6E5,
-        0xBE2B5B58, 0xBAEA46EF, 0xB7A96036, 0xB3687D81,
-        0xAD2F2D84, 0xA9EE3033, 0xA4AD16EA, 0xA06C0B5D,
-        0xD4326D90, 0xD0F37027, 0xDDB056FE, 0xD9714B49,
-        0xC7361B4C, 0xC3F706FB, 0xCEB42022, 0xCA753D95,
-        0xF23A8028, 0xF6FB9D9F, 0xFBB8BB46, 0xFF79A6F1,
-        0xE13EF6F4, 0xE5FFEB43, 0xE8BCCD9A, 0xEC7DD02D,
-        0x34867077, 0x30476DC0, 0x3D044B19, 0x39C556AE,
-        0x278206AB, 0x23431B1C, 0x2E003DC5, 0x2AC12072,
-        0x128E9DCF, 0x164F8078, 0x1B0CA6A1, 0x1FCDBB16,
-        0x018AEB13, 0x054BF6A4, 0x0808D07D, 0x0CC9CDCA,
-        0x7897AB07, 0x7C56B6B0, 0x71159069, 0x75D48DDE,
-        0x6B93DDDB, 0x6F52C06C, 0x6211E6B5, 0x66D0FB02,
-        0x5E9F46BF, 0x5A5E5B08, 0x571D7DD1, 0x53DC6066,
-        0x4D9B3063, 0x495A2DD4, 0x44190B0D, 0x40D816BA,
-        0xACA5C697, 0xA864DB20, 0xA527FDF9, 0xA1E6E04E,
-        0xBFA1B04B, 0xBB60ADFC, 0xB6238B25, 0xB2E29692,
-        0x8AAD2B2F, 0x8E6C3698, 0x832F1041, 0x87EE0DF6,
-        0x99A95DF3, 0x9D684044, 0x902B669D, 0x94EA7B2A,
-        0xE0B41DE7, 0xE4750050, 0xE9362689, 0xEDF73B3E,
-        0xF3B06B3B, 0xF771768C, 0xFA325055, 0xFEF34DE2,
-        0xC6BCF05F, 0xC27DEDE8, 0xCF3ECB31, 0xCBFFD686,
-        0xD5B88683, 0xD1799B34, 0xDC3ABDED, 0xD8FBA05A,
-        0x690CE0EE, 0x6DCDFD59, 0x608EDB80, 0x644FC637,
-        0x7A089632, 0x7EC98B85, 0x738AAD5C, 0x774BB0EB,
-        0x4F040D56, 0x4BC510E1, 0x46863638, 0x42472B8F,
-        0x5C007B8A, 0x58C1663D, 0x558240E4, 0x51435D53,
-        0x251D3B9E, 0x21DC2629, 0x2C9F00F0, 0x285E1D47,
-        0x36194D42, 0x32D850F5, 0x3F9B762C, 0x3B5A6B9B,
-        0x0315D626, 0x07D4CB91, 0x0A97ED48, 0x0E56F0FF,
-        0x1011A0FA, 0x14D0BD4D, 0x19939B94, 0x1D528623,
-        0xF12F560E, 0xF5EE4BB9, 0xF8AD6D60, 0xFC6C70D7,
-        0xE22B20D2, 0xE6EA3D65, 0xEBA91BBC, 0xEF68060B,
-        0xD727BBB6, 0xD3E6A601, 0xDEA580D8, 0xDA649D6F,
-        0xC423CD6A, 0xC0E2D0DD, 0xCDA1F604, 0xC960EBB3,
-        0xBD3E8D7E, 0xB9FF90C9, 0xB4BCB610, 0xB07DABA7,
-        0xAE3AFBA2, 0xAAFBE615, 0xA7B8C0CC, 0xA379DD7B,
-        0x9B3660C6, 0x9FF77D71, 0x92B45BA8, 0x9675461F,
-        0x8832161A, 0x8CF30BAD, 0x81B02D74, 0x857130C3,
-        0x5D8A9099, 0x594B8D2E, 0x5408ABF7, 0x50C9B640,
-        0x4E8EE645, 0x4A4FFBF2, 0x470CDD2B, 0x43CDC09C,
-        0x7B827D21, 0x7F436096, 0x7200464F, 0x76C15BF8,
-        0x68860BFD, 0x6C47164A, 0x61043093, 0x65C52D24,
-        0x119B4BE9, 0x155A565E, 0x18197087, 0x1CD86D30,
-        0x029F3D35, 0x065E2082, 0x0B1D065B, 0x0FDC1BEC,
-        0x3793A651, 0x3352BBE6, 0x3E119D3F, 0x3AD08088,
-        0x2497D08D, 0x2056CD3A, 0x2D15EBE3, 0x29D4F654,
-        0xC5A92679, 0xC1683BCE, 0xCC2B1D17, 0xC8EA00A0,
-        0xD6AD50A5, 0xD26C4D12, 0xDF2F6BCB, 0xDBEE767C,
-        0xE3A1CBC1, 0xE760D676, 0xEA23F0AF, 0xEEE2ED18,
-        0xF0A5BD1D, 0xF464A0AA, 0xF9278673, 0xFDE69BC4,
-        0x89B8FD09, 0x8D79E0BE, 0x803AC667, 0x84FBDBD0,
-        0x9ABC8BD5, 0x9E7D9662, 0x933EB0BB, 0x97FFAD0C,
-        0xAFB010B1, 0xAB710D06, 0xA6322BDF, 0xA2F33668,
-        0xBCB4666D, 0xB8757BDA, 0xB5365D03, 0xB1F740B4,
-    };
-
-    // case translation table
-    uint8_t CRC::m_ToLower[256] =
-    {
-        0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,
-        0x08,0x09,0x0a,0x0b,0x0c,0x0d,0x0e,0x0f,
-        0x10,0x11,0x12,0x13,0x14,0x15,0x16,0x17,
-        0x18,0x19,0x1a,0x1b,0x1c,0x1d,0x1e,0x1f,
-        0x20,0x21,0x22,0x23,0x24,0x25,0x26,0x27,
-        0x28,0x29,0x2a,0x2b,0x2c,0x2d,0x2e,0x2f,
-        0x30,0x31,0x32,0x33,0x34,0x35,0x36,0x37,
-        0x38,0x39,0x3a,0x3b,0x3c,0x3d,0x3e,0x3f,
-        0x40,0x61,0x62,0x63,0x64,0x65,0x66,0x67,
-        0x68,0x69,0x6a,0x6b,0x6c,0x6d,0x6e,0x6f,
-        0x70,0x71,0x72,0x73,0x74,0x75,0x76,0x77,
-        0x78,0x79,0x7a,0x5b,0x5c,0x5d,0x5e,0x5f,
-        0x60,0x61,0x62,0x63,0x64,0x65,0x66,0x67,
-        0x68,0x69,0x6a,0x6b,0x6c,0x6d,0x6e,0x6f,
-        0x70,0x71,0x72,0x73,0x74,0x75,0x76,0x77,
-        0x78,0x79,0x7a,0x7b,0x7c,0x7d,0x7e,0x7f,
-        0x80,0x81,0x82,0x83,0x84,0x85,0x86,0x87,
-        0x88,0x89,0x8a,0x8b,0x8c,0x8d,0x8e,0x8f,
-        0x90,0x91,0x92,0x93,0x94,0x95,0x96,0x97,
-        0x98,0x99,0x9a,0x9b,0x9c,0x9d,0x9e,0x9f,
-        0xa0,0xa1,0xa2,0xa3,0xa4,0xa5,0xa6,0xa7,
-        0xa8,0xa9,0xaa,0xab,0xac,0xad,0xae,0xaf,
-        0xb0,0xb1,0xb2,0xb3,0xb4,0xb5,0xb6,0xb7,
-        0xb8,0xb9,0xba,0xbb,0xbc,0xbd,0xbe,0xbf,
-        0xc0,0xc1,0xc2,0xc3,0xc4,0xc5,0xc6,0xc7,
-        0xc8,0xc9,0xca,0xcb,0xcc,0xcd,0xce,0xcf,
-        0xd0,0xd1,0xd2,0xd3,0xd4,0xd5,0xd6,0xd7,
-        0xd8,0xd9,0xda,0xdb,0xdc,0xdd,0xde,0xdf,
-        0xe0,0xe1,0xe2,0xe3,0xe4,0xe5,0xe6,0xe7,
-        0xe8,0xe9,0xea,0xeb,0xec,0xed,0xee,0xef,
-        0xf0,0xf1,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7,
-        0xf8,0xf9,0xfa,0xfb,0xfc,0xfd,0xfe,0xff,
-    };
+        std::vector<std::string_view> views;
+        std::vector<const std::string *> kept;
+
+        for (const auto &name : names)
+        {
+            if (!name.empty() && name.find('\0') == std::string::npos)
+            {
+                views.push_back(name);
+                kept.push_back(&name);
+            }
+        }
+
+        std::vector<FNVHash> hashes(views.size());
+        HashBatch(views, hashes);
+
+        std::vector<std::pair<FNVHash, const std::string *>> hashed;
+        hashed.reserve(kept.size());
+
+        for (std::size_t i = 0; i < kept.size(); ++i)
+        {
+            hashed.emplace_back(hashes[i], kept[i]);
+        }
+
+        // colliding names keep the first given
+        std::ranges::stable_sort(hashed, {}, &std::pair<FNVHash, const std::string *>::first);
+        const auto duplicates = std::ranges::unique(hashed, {}, &std::pair<FNVHash, const std::string *>::first);
+        hashed.erase(duplicates.begin(), duplicates.end());
+
+        FNVDictionaryHeader header{
+            FNVDictionaryHeader::MAGIC,
+            FNVDictionaryHeader::VERSION,
+            static_cast<uint32_t>(hashed.size()),
+            static_cast<uint32_t>(sizeof(FNVDictionaryHeader) + hashed.size() * sizeof(FNVDictionaryEntry)),
+        };
+
+        std::vector<FNVDictionaryEntry> entries;
+        entries.reserve(hashed.size());
+
+        std::string strings;
+        for (const auto &[hash, name] : hashed)
+        {
+            entries.push_back({ hash, static_cast<uint32_t>(strings.size()) });
+            strings.append(*name);
+            strings.push_back('\0');
+        }
+
+        if (strings.empty())
+        {
+            strings.push_back('\0');
+        }
+
+        std::ofstream os{ filename, std::ios::binary | std::ios::trunc };
+        os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        os.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(FNVDictionaryEntry));
+        os.write(strings.data(), strings.size());
+
+        if (!os)
+        {
+            SWBF2_LOG(LogLevel::Error, __FILE__, ":", __LINE__, ": failed write ", filename.c_str(), " file");
+            return false;
+        }
+
+        return true;
+    }
 }
@@ -1,35 +1,60 @@
 #pragma once
 
+#include <span>
+
 #include "../Types.hpp"
 
 namespace SWBF2
 {
     class CRC
     {
-    private:
-        static uint32_t m_Table32[256];
-        static uint8_t m_ToLower[256];
-
     public:
+        // Eight bytes per step through the slicing tables in Hashing.cpp
         static CRCChecksum CalcLowerCRC(const char *str);
+        static CRCChecksum CalcLowerCRC(std::string_view str);
     };
 
+    // FNV dictionary file: this header, m_count entries sorted by hash, then the
+    // NUL terminated names. Little endian like the lvl files.
+    typedef struct _FNV_DICTIONARY_HEADER
+    {
+        static constexpr uint32_t MAGIC = 0x44564E46; // "FNVD"
+        static constexpr uint32_t VERSION = 1;
+
+        uint32_t m_magic;
+        uint32_t m_version;
+        uint32_t m_count;
+        uint32_t m_stringsOffset; // from the start of the file
+    } FNVDictionaryHeader;
+
+    typedef struct _FNV_DICTIONARY_ENTRY
+    {
+        FNVHash m_hash;
+        uint32_t m_offset; // from m_stringsOffset
+    } FNVDictionaryEntry;
+
     class FNV
     {
     public:
+        static constexpr std::size_t BATCH_LANES = 8;
+
         static FNVHash Hash(const std::string &str);
-        static bool Lookup(FNVHash hash, std::string &result);
 
-        static constexpr FNVHash HashConstexpr(const std::string_view str);
+        // Same hashes as Hash for each of strings. BATCH_LANES strings of about the
+        // same length are stepped together, so one string's multiply doesn't wait
+        // on the one before.
+        static void HashBatch(std::span<const std::string_view> strings, std::span<FNVHash> hashes);
 
-#ifdef LOOKUP_CSV_PATH
-    private:
-        static std::unordered_map<FNVHash, std::string> *p_LookupTable;
+        // Reverse lookups search the mapped dictionary, nothing is parsed or
+        // copied on open and processes share its pages
+        static bool Lookup(FNVHash hash, std::string &result);
+        static std::optional<std::string> Lookup(FNVHash hash);
 
-    public:
-        static void ReadLookupTable();
-        static void ReleaseLookupTable();
-#endif // LOOKUP_CSV_PATH
+        static bool OpenLookupTable(const std::string &filename); // replaces an open one
+        static void CloseLookupTable();
+        static bool WriteLookupTable(const std::string &filename, const std::vector<std::string> &names);
+
+        static constexpr FNVHash HashConstexpr(const std::string_view str);
     };
 
 
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "ChunkHeader.hpp"
+#include "LoadProfile.hpp"
+#include "NestedChunkRegistry.hpp"
+
+namespace SWBF2
+{
+    namespace
+    {
+        typedef struct _PROFILE_STATE
+        {
+            std::mutex m_mutex;
+            std::map<std::string, const LoadProfile *> m_profiles;
+
+            // Loads on other threads may still hold a replaced profile, so none is freed before Reset
+            std::vector<std::unique_ptr<LoadProfile>> m_storage;
+        } ProfileState;
+
+        const LoadProfile *AddProfile(ProfileState &state, const std::string &name, const std::vector<ChunkSkip> &skips, VBUFFlags vertexAttributes)
+        {
+            state.m_storage.push_back(std::make_unique<LoadProfile>(name, skips, vertexAttributes));
+            state.m_profiles[name] = state.m_storage.back().get();
+            return state.m_storage.back().get();
+        }
+
+        void AddBuiltInProfiles(ProfileState &state)
+        {
+            AddProfile(state, LoadProfiles::FULL, {}, LoadProfile::ALL_VERTEX_ATTRIBUTES);
+            AddProfile(state, LoadProfiles::LOW, { { LoadProfile::ANY_PARENT, "shdw"_m } }, LoadProfile::ALL_VERTEX_ATTRIBUTES);
+            AddProfile(state, LoadProfiles::SERVER,
+                       {
+                           { LoadProfile::ANY_PARENT, "tex_"_m },
+                           { LoadProfile::ANY_PARENT, "font"_m },
+                           { LoadProfile::ANY_PARENT, "fx__"_m },
+                           { LoadProfile::ANY_PARENT, "hud_"_m },
+                       },
+                       VBUFFlags::Position);
+        }
+
+        ProfileState &GetState()
+        {
+            static ProfileState state;
+            static std::once_flag builtIns;
+
+            std::call_once(builtIns, [] { AddBuiltInProfiles(state); });
+            return state;
+        }
+
+        std::optional<uint32_t> ParseMagic(std::string_view text)
+        {
+            if (text.size() == 4)
+            {
+                uint32_t magic = 0;
+                for (std::size_t i = 0; i < 4; ++i)
+                {
+                    magic |= static_cast<uint32_t>(static_cast<uint8_t>(text[i])) << (i * 8);
+                }
+
+                return magic;
+            }
+
+            if (!text.empty())
+            {
+                return FNV::HashConstexpr(text);
+            }
+
+            return std::nullopt;
+        }
+    }
+
+    LoadProfile::LoadProfile(std::string name, const std::vector<ChunkSkip> &skips, VBUFFlags vertexAttributes)
+        : m_name(std::move(name)), m_skips(skips), m_vertexAttributes(vertexAttributes)
+    {
+        for (const auto &skip : m_skips)
+        {
+            m_keys.push_back(GetNestedChunkKey(skip.m_parent, skip.m_child));
+        }
+
+        std::ranges::sort(m_keys);
+    }
+
+    const std::string &LoadProfile::GetName() const
+    {
+        return m_name;
+    }
+
+    const std::vector<ChunkSkip> &LoadProfile::GetSkips() const
+    {
+        return m_skips;
+    }
+
+    VBUFFlags LoadProfile::GetVertexAttributes() const
+    {
+        return m_vertexAttributes;
+    }
+
+    bool LoadProfile::IsSkipped(uint32_t parent, uint32_t child) const
+    {
+        if (m_keys.empty())
+        {
+            return false;
+        }
+
+        return std::ranges::binary_search(m_keys, GetNestedChunkKey(parent, child)) ||
+               std::ranges::binary_search(m_keys, GetNestedChunkKey(ANY_PARENT, child));
+    }
+
+    void LoadProfiles::Register(const std::string &name, const std::vector<ChunkSkip> &skips, VBUFFlags vertexAttributes)
+    {
+        auto &state = GetState();
+        std::lock_guard lock{ state.m_mutex };
+
+        const auto *previous = state.m_profiles.contains(name) ? state.m_profiles[name] : nullptr;
+        const auto *profile = AddProfile(state, name, skips, vertexAttributes);
+
+        if (previous != nullptr && m_active.load(std::memory_order_relaxed) == previous)
+        {
+            m_active.store(profile, std::memory_order_release);
+        }
+    }
+
+    bool LoadProfiles::SetActive(const std::string &name)
+    {
+        auto &state = GetState();
+        std::lock_guard lock{ state.m_mutex };
+
+        auto it = state.m_profiles.find(name);
+        if (it == state.m_profiles.end())
+        {
+            return false;
+        }
+
+        m_active.store(it->second, std::memory_order_release);
+        return true;
+    }
+
+    const LoadProfile &LoadProfiles::GetActive()
+    {
+        const auto *profile = m_active.load(std::memory_order_acquire);
+        if (profile == nullptr)
+        {
+            auto &state = GetState();
+            std::lock_guard lock{ state.m_mutex };
+
+            return *state.m_profiles.at(FULL);
+        }
+
+        return *profile;
+    }
+
+    std::vector<std::string> LoadProfiles::GetNames()
+    {
+        auto &state = GetState();
+        std::lock_guard lock{ state.m_mutex };
+
+        std::vector<std::string> names;
+        for (const auto &[name, profile] : state.m_profiles)
+        {
+            names.push_back(name);
+        }
+
+        return names;
+    }
+
+    void LoadProfiles::Reset()
+    {
+        auto &state = GetState();
+        std::lock_guard lock{ state.m_mutex };
+
+        m_active.store(nullptr, std::memory_order_release);
+
+        state.m_profiles.clear();
+        state.m_storage.clear();
+        AddBuiltInProfiles(state);
+    }
+
+    std::optional<ChunkSkip> LoadProfiles::ParseSkip(std::string_view text)
+    {
+        const auto slash = text.find('/');
+        if (slash == std::string_view::npos)
+        {
+            return std::nullopt;
+        }
+
+        const auto parentText = text.substr(0, slash);
+        const auto child = ParseMagic(text.substr(slash + 1));
+        if (!child)
+        {
+            return std::nullopt;
+        }
+
+        if (parentText == "*")
+        {
+            return ChunkSkip{ LoadProfile::ANY_PARENT, *child };
+        }
+
+        const auto parent = ParseMagic(parentText);
+        if (!parent)
+        {
+            return std::nullopt;
+        }
+
+        return ChunkSkip{ *parent, *child };
+    }
+}
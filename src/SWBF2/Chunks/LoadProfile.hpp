@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+
+#include "../Types.hpp"
+#include "../ModelSegment.hpp"
+
+namespace SWBF2
+{
+    typedef struct _CHUNK_SKIP
+    {
+        uint32_t m_parent; // ANY_PARENT matches every parent
+        uint32_t m_child;
+    } ChunkSkip;
+
+    // Subtrees a load never visits. A skipped chunk costs the header read and
+    // the seek over its body that every child walk does anyway. Vertex
+    // attributes left out of m_vertexAttributes are not kept from VBUF.
+    class LoadProfile {
+    public:
+        static constexpr uint32_t ANY_PARENT = 0;
+
+        static constexpr VBUFFlags ALL_VERTEX_ATTRIBUTES = static_cast<VBUFFlags>(
+            VBUFFlags::Position | VBUFFlags::Unknown1 | VBUFFlags::BlendWeight | VBUFFlags::Normal |
+            VBUFFlags::Tangents | VBUFFlags::Color | VBUFFlags::StaticLighting | VBUFFlags::TexCoord);
+
+        LoadProfile(std::string name, const std::vector<ChunkSkip> &skips, VBUFFlags vertexAttributes = ALL_VERTEX_ATTRIBUTES);
+
+        const std::string &GetName() const;
+        const std::vector<ChunkSkip> &GetSkips() const;
+        VBUFFlags GetVertexAttributes() const;
+
+        bool IsSkipped(uint32_t parent, uint32_t child) const;
+
+    private:
+        std::string m_name;
+        std::vector<ChunkSkip> m_skips;
+        std::vector<uint64_t> m_keys; // sorted (parent, child) pairs
+        VBUFFlags m_vertexAttributes;
+    };
+
+    class LoadProfiles {
+    public:
+        static constexpr const char *FULL = "full"; // visits everything
+        static constexpr const char *LOW = "low";   // no shadow volumes
+
+        // Dedicated servers: no textures, fonts, effects or HUD, and only positions
+        // and indices of models. Collision, world, ODF classes and scripts are kept.
+        static constexpr const char *SERVER = "server";
+
+        // Adds or replaces a profile. Replacing the active one makes the new skips active.
+        static void Register(const std::string &name, const std::vector<ChunkSkip> &skips, VBUFFlags vertexAttributes = LoadProfile::ALL_VERTEX_ATTRIBUTES);
+        static bool SetActive(const std::string &name); // false for unknown names
+        static const LoadProfile &GetActive();
+        static std::vector<std::string> GetNames();
+
+        // Back to the built-in profiles with none active, must not run alongside loads
+        static void Reset();
+
+        // "parent/child", each a four character magic, a sound bank name hashed
+        // like the files do, or "*" for any parent
+        static std::optional<ChunkSkip> ParseSkip(std::string_view text);
+
+        static bool IsSkipped(uint32_t parent, uint32_t child)
+        {
+            const auto *profile = m_active.load(std::memory_order_acquire);
+            return profile != nullptr && profile->IsSkipped(parent, child);
+        }
+
+        static VBUFFlags GetVertexAttributes()
+        {
+            const auto *profile = m_active.load(std::memory_order_acquire);
+            return profile != nullptr ? profile->GetVertexAttributes() : LoadProfile::ALL_VERTEX_ATTRIBUTES;
+        }
+
+    private:
+        // nullptr until a profile is picked, which is the same as FULL
+        static inline constinit std::atomic<const LoadProfile *> m_active{ nullptr };
+    };
+}
@@ -1,57 +1,146 @@
-#include <godot_cpp/variant/utility_functions.hpp>
-
 #include "StreamReader.hpp"
 
 #include "ModelChunk.hpp"
 #include "ModelSegmentChunk.hpp"
+#include "NestedChunkRegistry.hpp"
 
+#include "../BatchIndex.hpp"
+#include "../Logging.hpp"
 #include "../Models.hpp"
 #include "../Model.hpp"
 #include "../ModelSegment.hpp"
+#include "../Threading/ThreadPool.hpp"
 
 namespace SWBF2
 {
     void ModelChunk::ProcessChunk(StreamReader &streamReader)
     {
-        Model model;
+        ModelSource source{ std::string{ streamReader.GetSource() }, streamReader.GetOffset(), streamReader.GetHeader().size };
 
-        auto modelNameReaderChild = streamReader.ReadChildWithHeader<"NAME"_m>();
+        auto model = DecodeHeader(streamReader);
 
-        *modelNameReaderChild >> model.m_name;
+        // lazy models decode from the mapping later, so they keep it alive.
+        // Eager models don't, an evicted one re-reads just its own span from disk.
+        const auto lazy = Models::GetDecodeMode() == ModelDecodeMode::Lazy;
+        if (lazy && streamReader.GetBuffer() && streamReader.GetBuffer()->IsMapped())
+        {
+            source.m_buffer = streamReader.GetBuffer();
+        }
 
-        auto vertexReaderChild = streamReader.ReadChildWithHeader<"VRTX"_m>();
+        // another chunk of the same load batch provides this model
+        const auto &batchIndex = Executor::GetCurrentContext().m_batchIndex;
+        if (batchIndex && !batchIndex->Claim(model.m_name, model.m_info, source))
+        {
+            return;
+        }
 
-        std::vector<std::byte> vertex;
-        vertex.resize(vertexReaderChild->GetHeader().size);
+        if (lazy)
+        {
+            Models::InsertLazy(model.m_name, model.m_info, source);
+            return;
+        }
 
-        *vertexReaderChild >> vertex;
+        DecodeBody(streamReader, model);
+        Models::Insert(std::move(model), source);
+    }
 
-        auto nodeReaderChild = streamReader.ReadChildWithHeader<"NODE"_m>();
+    std::optional<Model> ModelChunk::ReadModel(const ModelSource &source)
+    {
+        auto buffer = source.m_buffer;
+        if (!buffer)
+        {
+            buffer = FileBuffer::Read(source.m_filename, source.m_offset, sizeof(ChunkHeader) + source.m_size);
+        }
 
-        *nodeReaderChild >> model.m_node;
+        if (!buffer)
+        {
+            SWBF2_LOG(LogLevel::Error, __FILE__, ":", __LINE__, ": failed read model at ", source.m_offset, " of ", source.m_filename.c_str(), " file");
+            return std::nullopt;
+        }
 
-        auto infoReaderChild = streamReader.ReadChildWithHeader<"INFO"_m>();
+        StreamReader streamReader{ std::move(buffer), source.m_offset };
+        if (streamReader.GetHeader().m_Magic != "modl"_m)
+        {
+            char name[ChunkHeader::FORMATTED_SIZE];
+            SWBF2_LOG(LogLevel::Error, __FILE__, ":", __LINE__, ": expected modl at ", source.m_offset, " of ", source.m_filename.c_str(), ", got ", streamReader.GetHeader().Format(name));
+            return std::nullopt;
+        }
 
-        *infoReaderChild >> model.m_info;
+        return DecodeModel(streamReader);
+    }
+
+    Model ModelChunk::DecodeModel(StreamReader &streamReader)
+    {
+        Model model = DecodeHeader(streamReader);
+        DecodeBody(streamReader, model);
+        return model;
+    }
+
+    void ModelChunk::DecodeBody(StreamReader &streamReader, Model &model)
+    {
+        std::vector<StreamReader> segments;
+
+        NestedChunkState state{ &model, nullptr, &segments };
+        NestedChunkRegistry::ProcessChildren(streamReader, state);
+
+        DecodeSegments(segments, model);
+    }
+
+    void ModelChunk::CollectSegment(StreamReader &streamReader, NestedChunkState &state)
+    {
+        state.m_segments->push_back(streamReader);
+    }
 
-        std::optional<StreamReader> readerChild;
-        while ((readerChild = streamReader.ReadChild()).has_value())
+    void ModelChunk::DecodeSegments(std::vector<StreamReader> &segments, Model &model)
+    {
+        model.m_segments.resize(segments.size());
+
+        // big segments become subtasks, small ones are decoded here while those run
+        TaskGroup tasks;
+
+        for (std::size_t i = 0; i < segments.size(); ++i)
         {
-            switch (readerChild->GetHeader().m_Magic)
+            if (segments.size() > 1 && segments[i].GetHeader().size >= PARALLEL_SEGMENT_BYTES)
             {
-                case "segm"_m: {
-                    StreamReader r{ *readerChild };
-                    ModelSegmentChunk::ProcessChunk(r, model);
-                    break;
-                }
-
-                case "SPHR"_m:
-                default:
-                    godot::UtilityFunctions::printerr(__FILE__, ":", __LINE__, ": ", readerChild->GetHeader().ToString().c_str(), " not implemented");
-                    break;
+                tasks.Run([&segments, &model, i]
+                    {
+                        Executor::GetCurrentContext().m_token.ThrowIfCancelled();
+                        model.m_segments[i] = ModelSegmentChunk::ProcessChunk(segments[i], model);
+                    });
             }
         }
 
-        Models::m_models.insert_or_assign(model.m_name, model);
+        for (std::size_t i = 0; i < segments.size(); ++i)
+        {
+            if (segments.size() == 1 || segments[i].GetHeader().size < PARALLEL_SEGMENT_BYTES)
+            {
+                Executor::GetCurrentContext().m_token.ThrowIfCancelled();
+                model.m_segments[i] = ModelSegmentChunk::ProcessChunk(segments[i], model);
+            }
+        }
+
+        tasks.Wait();
+    }
+
+    Model ModelChunk::DecodeHeader(StreamReader &streamReader)
+    {
+        Model model;
+
+        auto modelNameReaderChild = streamReader.ReadChildWithHeader<"NAME"_m>();
+
+        *modelNameReaderChild >> model.m_name;
+
+        // VRTX is unused, reading the child only checks it and moves past it
+        streamReader.ReadChildWithHeader<"VRTX"_m>();
+
+        auto nodeReaderChild = streamReader.ReadChildWithHeader<"NODE"_m>();
+
+        *nodeReaderChild >> model.m_node;
+
+        auto infoReaderChild = streamReader.ReadChildWithHeader<"INFO"_m>();
+
+        *infoReaderChild >> model.m_info;
+
+        return model;
     }
 }
@@ -2,11 +2,31 @@
 
 #include "StreamReader.hpp"
 
+#include "../Model.hpp"
+#include "../Models.hpp"
+
 namespace SWBF2
 {
+    struct NestedChunkState;
+
     class ModelChunk {
     public:
         static void ProcessChunk(StreamReader &streamReader);
+
+        static std::optional<Model> ReadModel(const ModelSource &source);
+
+        static constexpr ChunkSize PARALLEL_SEGMENT_BYTES = 16 * 1024;
+
+    private:
+        static Model DecodeModel(StreamReader &streamReader);
+        static Model DecodeHeader(StreamReader &streamReader);
+        static void DecodeBody(StreamReader &streamReader, Model &model);
+        static void DecodeSegments(std::vector<StreamReader> &segments, Model &model);
+
+        // segments are only collected here, DecodeSegments reads them once the body is walked
+        static void CollectSegment(StreamReader &streamReader, NestedChunkState &state);
+
+        friend class NestedChunkRegistry;
     };
 
 }
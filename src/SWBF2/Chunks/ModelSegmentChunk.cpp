@@ -1,105 +1,184 @@
-#include <godot_cpp/variant/utility_functions.hpp>
-
+#include "ChunkProfiler.hpp"
+#include "LoadProfile.hpp"
 #include "StreamReader.hpp"
 
 #include "ModelSegmentChunk.hpp"
+#include "NestedChunkRegistry.hpp"
 
 namespace SWBF2
 {
-    void ModelSegmentChunk::ProcessChunk(StreamReader &streamReader, Model &model)
+    ModelSegment ModelSegmentChunk::ProcessChunk(StreamReader &streamReader, const Model &model)
     {
+        ChunkProfileScope profile{ streamReader };
+
         ModelSegment segment;
 
         auto infoReaderChild = streamReader.ReadChildWithHeader<"INFO"_m>();
 
         *infoReaderChild >> segment.m_info;
 
-        std::optional<StreamReader> readerChild;
-        while ((readerChild = streamReader.ReadChild()).has_value())
+        NestedChunkState state{ &model, &segment, nullptr };
+        NestedChunkRegistry::ProcessChildren(streamReader, state);
+
+        return segment;
+    }
+
+    void ModelSegmentChunk::ProcessMaterial(StreamReader &streamReader, NestedChunkState &state)
+    {
+        auto &segment = *state.m_segment;
+
+        Material mat;
+        streamReader >> mat.m_flags;
+        streamReader >> mat.m_diffuseColor.color32;
+        streamReader >> mat.m_specularColor.color32;
+        streamReader >> mat.m_specularExponent;
+        streamReader >> mat.m_parameters[0];
+        streamReader >> mat.m_parameters[1];
+        streamReader >> mat.m_attachedLight;
+
+        segment.m_material = mat;
+    }
+
+    void ModelSegmentChunk::ProcessRenderType(StreamReader &streamReader, NestedChunkState &state)
+    {
+        auto &segment = *state.m_segment;
+
+        streamReader >> segment.p_renderType;
+    }
+
+    void ModelSegmentChunk::ProcessIndexBuffer(StreamReader &streamReader, NestedChunkState &state)
+    {
+        auto &segment = *state.m_segment;
+
+        streamReader >> segment.m_indicesBuf.m_indicesCount;
+
+        segment.m_indicesBuf.m_indices.resize(segment.m_indicesBuf.m_indicesCount);
+
+        streamReader >> segment.m_indicesBuf.m_indices;
+    }
+
+    void ModelSegmentChunk::ProcessVertexBuffer(StreamReader &streamReader, NestedChunkState &state)
+    {
+        auto &segment = *state.m_segment;
+
+        streamReader >> segment.m_verticesBuf.m_verticesCount;
+        streamReader >> segment.m_verticesBuf.m_stride;
+        streamReader >> segment.m_verticesBuf.m_flags;
+
+        const auto attributes = LoadProfiles::GetVertexAttributes();
+        if (attributes == VBUFFlags::Position && ReadPositionsOnly(streamReader, *state.m_model, segment))
+        {
+            return;
+        }
+
+        for (uint32_t i = 0; i < segment.m_verticesBuf.m_verticesCount; ++i)
+        {
+            ProcessVerticesBuffer(streamReader, *state.m_model, segment);
+        }
+
+        if (attributes != LoadProfile::ALL_VERTEX_ATTRIBUTES)
+        {
+            DropAttributes(segment.m_verticesBuf, attributes);
+        }
+    }
+
+    void ModelSegmentChunk::ReadPosition(StreamReader &streamReader, const Model &model, ModelSegment &segment)
+    {
+        if ((segment.m_verticesBuf.m_flags & VBUFFlags::PositionCompressed) != 0)
+        {
+            Vector3<float> low = model.m_info.m_vertexBox[0];
+            Vector3<float> mul = model.m_info.m_vertexBox[1] - model.m_info.m_vertexBox[0];
+
+            int16_t data[4];
+            streamReader >> data[0] >> data[1] >> data[2] >> data[3];
+            Vector3<float> c(data[0], data[1], data[2]);
+
+            constexpr float i16min = std::numeric_limits<int16_t>::min();
+            constexpr float i16max = std::numeric_limits<int16_t>::max();
+
+            segment.m_verticesBuf.m_positions.push_back((low + (c - i16min) * mul / (i16max - i16min)));
+        }
+        else
+        {
+            Vector3<float> vec3;
+            streamReader >> vec3;
+
+            segment.m_verticesBuf.m_positions.push_back(vec3);
+        }
+    }
+
+    bool ModelSegmentChunk::ReadPositionsOnly(StreamReader &streamReader, const Model &model, ModelSegment &segment)
+    {
+        auto &vertices = segment.m_verticesBuf;
+
+        // the position leads each vertex, the rest of the stride is stepped over
+        const uint32_t positionBytes = (vertices.m_flags & VBUFFlags::Position) == 0 ? 0 :
+                                       (vertices.m_flags & VBUFFlags::PositionCompressed) != 0 ? 4 * sizeof(int16_t) : 3 * sizeof(float);
+        if (vertices.m_stride < positionBytes)
         {
-            switch (readerChild->GetHeader().m_Magic)
+            return false;
+        }
+
+        vertices.m_positions.reserve(positionBytes != 0 ? vertices.m_verticesCount : 0);
+
+        for (uint32_t i = 0; i < vertices.m_verticesCount; ++i)
+        {
+            if (positionBytes != 0)
             {
-                case "MTRL"_m:
-                {
-                    Material mat;
-                    *readerChild >> mat.m_flags;
-                    *readerChild >> mat.m_diffuseColor.color32;
-                    *readerChild >> mat.m_specularColor.color32;
-                    *readerChild >> mat.m_specularExponent;
-                    *readerChild >> mat.m_parameters[0];
-                    *readerChild >> mat.m_parameters[1];
-                    *readerChild >> mat.m_attachedLight;
-
-                    segment.m_material = mat;
-
-                    break;
-                }
-                case "RTYP"_m:
-                {
-                    *readerChild >> segment.p_renderType;
-                    break;
-                }
-                case "IBUF"_m:
-                {
-                    *readerChild >> segment.m_indicesBuf.m_indicesCount;
-
-                    segment.m_indicesBuf.m_indices.resize(segment.m_indicesBuf.m_indicesCount);
-
-                    *readerChild >> segment.m_indicesBuf.m_indices;
-                    break;
-                }
-                case "VBUF"_m:
-                {
-                    *readerChild >> segment.m_verticesBuf.m_verticesCount;
-                    *readerChild >> segment.m_verticesBuf.m_stride;
-                    *readerChild >> segment.m_verticesBuf.m_flags;
-
-                    for (uint32_t i = 0; i < segment.m_verticesBuf.m_verticesCount; ++i)
-                    {
-                        ProcessVerticesBuffer(*readerChild, model, segment);
-                    }
-
-                    break;
-                }
-                case "BNAM"_m:
-                case "SKIN"_m:
-                case "BMAP"_m:
-                case "TNAM"_m:
-                case "MNAM"_m:
-                default:
-                    godot::UtilityFunctions::printerr(__FILE__, ":", __LINE__, ": ", readerChild->GetHeader().ToString().c_str(), " not implemented");
-                    break;
+                ReadPosition(streamReader, model, segment);
             }
+
+            streamReader.SkipBytes(vertices.m_stride - positionBytes);
         }
 
-        model.m_segments.push_back(segment);
+        return true;
     }
 
-    void ModelSegmentChunk::ProcessVerticesBuffer(StreamReader &streamReader, Model &model, ModelSegment &segment)
+    void ModelSegmentChunk::DropAttributes(VerticesBuf &vertices, VBUFFlags keep)
     {
-        if ((segment.m_verticesBuf.m_flags & VBUFFlags::Position) != 0)
+        // swapped out rather than cleared so the memory goes back
+        if ((keep & VBUFFlags::Position) == 0)
         {
-            if ((segment.m_verticesBuf.m_flags & VBUFFlags::PositionCompressed) != 0)
-            {
-                Vector3<float> low = model.m_info.m_vertexBox[0];
-                Vector3<float> mul = model.m_info.m_vertexBox[1] - model.m_info.m_vertexBox[0];
+            std::vector<Vector3<float>>().swap(vertices.m_positions);
+        }
 
-                int16_t data[4];
-                streamReader >> data[0] >> data[1] >> data[2] >> data[3];
-                Vector3<float> c(data[0], data[1], data[2]);
+        if ((keep & VBUFFlags::Normal) == 0)
+        {
+            std::vector<Vector3<float>>().swap(vertices.m_normals);
+        }
 
-                constexpr float i16min = std::numeric_limits<int16_t>::min();
-                constexpr float i16max = std::numeric_limits<int16_t>::max();
+        if ((keep & VBUFFlags::Tangents) == 0)
+        {
+            std::vector<Vector3<float>>().swap(vertices.m_tangents);
+            std::vector<Vector3<float>>().swap(vertices.m_biTangents);
+        }
 
-                segment.m_verticesBuf.m_positions.push_back((low + (c - i16min) * mul / (i16max - i16min)));
-            }
-            else
-            {
-                Vector3<float> vec3;
-                streamReader >> vec3;
+        if ((keep & (VBUFFlags::Color | VBUFFlags::StaticLighting)) == 0)
+        {
+            std::vector<RGBA>().swap(vertices.m_colors);
+        }
 
-                segment.m_verticesBuf.m_positions.push_back(vec3);
-            }
+        if ((keep & VBUFFlags::TexCoord) == 0)
+        {
+            std::vector<Vector2<float>>().swap(vertices.m_texCoords);
+        }
+
+        if ((keep & VBUFFlags::Unknown1) == 0)
+        {
+            std::vector<Vector3<uint8_t>>().swap(vertices.m_boneIndices);
+        }
+
+        if ((keep & VBUFFlags::BlendWeight) == 0)
+        {
+            std::vector<Vector3<float>>().swap(vertices.m_weights);
+        }
+    }
+
+    void ModelSegmentChunk::ProcessVerticesBuffer(StreamReader &streamReader, const Model &model, ModelSegment &segment)
+    {
+        if ((segment.m_verticesBuf.m_flags & VBUFFlags::Position) != 0)
+        {
+            ReadPosition(streamReader, model, segment);
         }
 
         if ((segment.m_verticesBuf.m_flags & VBUFFlags::BlendWeight) != 0)
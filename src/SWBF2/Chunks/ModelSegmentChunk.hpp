@@ -6,11 +6,25 @@
 
 namespace SWBF2
 {
+    struct NestedChunkState;
+
     class ModelSegmentChunk {
     public:
-        static void ProcessChunk(StreamReader &streamReader, Model &model);
+        static ModelSegment ProcessChunk(StreamReader &streamReader, const Model &model);
+
+        static void ProcessVerticesBuffer(StreamReader &streamReader, const Model &model, ModelSegment &segment);
+
+    private:
+        static void ProcessMaterial(StreamReader &streamReader, NestedChunkState &state);
+        static void ProcessRenderType(StreamReader &streamReader, NestedChunkState &state);
+        static void ProcessIndexBuffer(StreamReader &streamReader, NestedChunkState &state);
+        static void ProcessVertexBuffer(StreamReader &streamReader, NestedChunkState &state);
+
+        static void ReadPosition(StreamReader &streamReader, const Model &model, ModelSegment &segment);
+        static bool ReadPositionsOnly(StreamReader &streamReader, const Model &model, ModelSegment &segment);
+        static void DropAttributes(VerticesBuf &vertices, VBUFFlags keep);
 
-        static void ProcessVerticesBuffer(StreamReader &streamReader, Model& model, ModelSegment &segment);
+        friend class NestedChunkRegistry;
     };
 
 }
@@ -0,0 +1,39 @@
+#include "ChunkProfiler.hpp"
+#include "LoadProfile.hpp"
+#include "NestedChunkRegistry.hpp"
+
+#include "../Logging.hpp"
+
+namespace SWBF2
+{
+    void NestedChunkRegistry::ProcessChildren(StreamReader &streamReader, NestedChunkState &state)
+    {
+        const auto parent = streamReader.GetHeader().m_Magic;
+
+        std::optional<StreamReader> readerChild;
+        while ((readerChild = streamReader.ReadChild()).has_value())
+        {
+            const auto child = readerChild->GetHeader().m_Magic;
+            if (LoadProfiles::IsSkipped(parent, child))
+            {
+                continue;
+            }
+
+            const auto *entry = Find(parent, child);
+            if (entry == nullptr)
+            {
+                Logging::CountUnhandledChunk(readerChild->GetSource(), child);
+                continue;
+            }
+
+            if (entry->m_deferred)
+            {
+                entry->m_function(*readerChild, state);
+                continue;
+            }
+
+            ChunkProfileScope profile{ *readerChild };
+            entry->m_function(*readerChild, state);
+        }
+    }
+}
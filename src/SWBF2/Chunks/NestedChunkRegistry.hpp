@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../Types.hpp"
+
+#include "ChunkDispatchTable.hpp"
+#include "ChunkHeader.hpp"
+#include "StreamReader.hpp"
+
+#include "ModelChunk.hpp"
+#include "ModelSegmentChunk.hpp"
+
+namespace SWBF2
+{
+    constexpr uint64_t GetNestedChunkKey(uint32_t parent, uint32_t child)
+    {
+        return (static_cast<uint64_t>(parent) << 32) | child;
+    }
+
+    // What the walk over a parent's children has at hand, a handler uses the
+    // parts its parent fills in
+    struct NestedChunkState
+    {
+        const Model *m_model = nullptr;
+        ModelSegment *m_segment = nullptr;              // segm
+        std::vector<StreamReader> *m_segments = nullptr; // modl
+    };
+
+    using NestedChunkFunction = void (*)(StreamReader &streamReader, NestedChunkState &state);
+
+    typedef struct _NESTED_CHUNK_INFO
+    {
+        uint64_t m_key; // GetNestedChunkKey(parent, child)
+        NestedChunkFunction m_function;
+        bool m_deferred; // only collects the child, it is decoded and profiled later
+    } NestedChunkInfo;
+
+    // Handlers for chunks below the top level, keyed by parent and child magic.
+    // Top level chunks stay in ChunkProcessor, they also carry load graph dependencies.
+    class NestedChunkRegistry {
+    public:
+        // modl: SPHR is not implemented yet
+        // segm: BNAM, SKIN, BMAP, TNAM and MNAM are not implemented yet
+        static constexpr auto m_functions = MakeChunkDispatchTable<&NestedChunkInfo::m_key>(std::array{
+            NestedChunkInfo{ GetNestedChunkKey("modl"_m, "segm"_m), ModelChunk::CollectSegment, true },
+            NestedChunkInfo{ GetNestedChunkKey("segm"_m, "MTRL"_m), ModelSegmentChunk::ProcessMaterial, false },
+            NestedChunkInfo{ GetNestedChunkKey("segm"_m, "RTYP"_m), ModelSegmentChunk::ProcessRenderType, false },
+            NestedChunkInfo{ GetNestedChunkKey("segm"_m, "IBUF"_m), ModelSegmentChunk::ProcessIndexBuffer, false },
+            NestedChunkInfo{ GetNestedChunkKey("segm"_m, "VBUF"_m), ModelSegmentChunk::ProcessVertexBuffer, false },
+        });
+
+        static constexpr const NestedChunkInfo *Find(uint32_t parent, uint32_t child)
+        {
+            return m_functions.Find(GetNestedChunkKey(parent, child));
+        }
+
+        // Runs the handlers for the children of streamReader. Children the active
+        // load profile skips are stepped over, unhandled ones are counted for the log.
+        static void ProcessChildren(StreamReader &streamReader, NestedChunkState &state);
+    };
+}
@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <optional>
 
 #include <godot_cpp/variant/utility_functions.hpp>
@@ -13,21 +14,31 @@ namespace SWBF2
         m_head = 0;
         m_data = nullptr;
         m_header = { 0 };
+        m_offset = 0;
     }
 
-    StreamReader::StreamReader(const ChunkHeader &header, const std::byte *bytes)
+    StreamReader::StreamReader(const ChunkHeader &header, const std::byte *bytes, std::size_t offset, std::shared_ptr<const FileBuffer> buffer)
         : m_header(header),
         m_data(bytes),
-        m_head(0)
+        m_head(0),
+        m_offset(offset),
+        m_buffer(std::move(buffer))
     {
     }
 
-    StreamReader::StreamReader(const std::vector<std::byte> &bytes)
+    StreamReader::StreamReader(std::shared_ptr<const FileBuffer> buffer, std::size_t offset)
     {
+        if (offset < buffer->GetOffset() || offset - buffer->GetOffset() + sizeof(ChunkHeader) > buffer->GetSize())
+        {
+            throw std::runtime_error("eof");
+        }
+
         m_head = 0;
-        m_data = bytes.data();
+        m_offset = offset;
+        m_buffer = std::move(buffer);
+        m_data = m_buffer->GetData() + (offset - m_buffer->GetOffset());
 
-        m_header = reinterpret_cast<const ChunkHeader &>(m_data[0]);
+        std::memcpy(&m_header, m_data, sizeof(ChunkHeader));
 
         m_data = m_data + sizeof(ChunkHeader);
     }
@@ -46,7 +57,7 @@ namespace SWBF2
 
         AlignHead();
 
-        return StreamReader(child, m_data + prev_head);
+        return StreamReader(child, m_data + prev_head, m_offset + prev_head, m_buffer);
     }
 
     bool StreamReader::SkipBytes(uint32_t bytes)
@@ -60,11 +71,46 @@ namespace SWBF2
         return true;
     }
 
+    std::string_view StreamReader::ReadStringView()
+    {
+        if (IsEof())
+        {
+            return {};
+        }
+
+        const std::string_view rest{ reinterpret_cast<const char *>(&m_data[m_head]), GetHeader().size - m_head };
+        const auto length = std::min(rest.find('\0'), rest.size());
+
+        m_head += std::min(length + 1, rest.size());
+
+        return rest.substr(0, length);
+    }
+
     const ChunkHeader &StreamReader::GetHeader() const
     {
         return m_header;
     }
 
+    std::size_t StreamReader::GetOffset() const
+    {
+        return m_offset;
+    }
+
+    std::string_view StreamReader::GetSource() const
+    {
+        if (!m_buffer)
+        {
+            return {};
+        }
+
+        return m_buffer->GetFilename();
+    }
+
+    const std::shared_ptr<const FileBuffer> &StreamReader::GetBuffer() const
+    {
+        return m_buffer;
+    }
+
     std::size_t StreamReader::GetHead()
     {
         return m_head;
@@ -5,6 +5,7 @@
 #include <godot_cpp/variant/utility_functions.hpp>
 
 #include "ChunkHeader.hpp"
+#include "FileBuffer.hpp"
 
 namespace SWBF2
 {
@@ -15,10 +16,13 @@ namespace SWBF2
         const std::byte *m_data;
         std::size_t m_head;
 
+        std::size_t m_offset; // offset of the header in the source file
+        std::shared_ptr<const FileBuffer> m_buffer;
+
     public:
         StreamReader();
-        StreamReader(const ChunkHeader &header, const std::byte *bytes);
-        StreamReader(const std::vector<std::byte> &bytes);
+        StreamReader(const ChunkHeader &header, const std::byte *bytes, std::size_t offset, std::shared_ptr<const FileBuffer> buffer);
+        StreamReader(std::shared_ptr<const FileBuffer> buffer, std::size_t offset = 0);
 
         std::optional<StreamReader> ReadChild();
 
@@ -36,7 +40,13 @@ namespace SWBF2
         }
 
         bool SkipBytes(uint32_t bytes);
+
+        // Up to the next NUL or the end of the chunk, the view points into the buffer
+        std::string_view ReadStringView();
         const ChunkHeader &GetHeader() const;
+        std::size_t GetOffset() const;
+        std::string_view GetSource() const;
+        const std::shared_ptr<const FileBuffer> &GetBuffer() const;
         std::size_t GetHead();
         bool IsEof();
         void AlignHead();
@@ -1,56 +1,169 @@
 
-#include <iostream>
-#include <fstream>
-
-#include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+#include <map>
 
+#include "FileBuffer.hpp"
 #include "StreamReader.hpp"
 #include "ChunkProcessor.hpp"
+#include "LoadProfile.hpp"
 
 #include "UcfbChunk.hpp"
 
+#include "../Logging.hpp"
+#include "../MemoryAccounting.hpp"
+#include "../Threading/LoadGraph.hpp"
+
 namespace SWBF2
 {
-    void UcfbChunk::ReadUcfbFile(const std::string &filename)
+    namespace
     {
-        std::ifstream is{ filename,std::ios::binary | std::ios::ate };
-        if (!is.is_open())
+        void AddProgress(ReadProgress *progress, const StreamReader &child)
         {
-            godot::UtilityFunctions::printerr(__FILE__, ":", __LINE__, ": failed open ", filename.c_str(), " file");
-            return;
+            if (progress != nullptr)
+            {
+                progress->m_done.fetch_add(sizeof(ChunkHeader) + child.GetHeader().size, std::memory_order_relaxed);
+            }
         }
+    }
 
-        auto size = is.tellg();
-        std::vector<std::byte> bytes;
-        bytes.resize(size);
+    bool UcfbChunk::ReadUcfbFile(const std::string &filename, ReadProgress *progress)
+    {
+        Executor::GetCurrentContext().m_token.ThrowIfCancelled();
+
+        auto buffer = FileBuffer::Open(filename);
+        if (!buffer)
+        {
+            SWBF2_LOG(LogLevel::Error, __FILE__, ":", __LINE__, ": failed open ", filename.c_str(), " file");
+            return false;
+        }
+
+        return ReadUcfbFile(std::move(buffer), progress);
+    }
+
+    bool UcfbChunk::ReadUcfbFile(std::shared_ptr<const FileBuffer> buffer, ReadProgress *progress)
+    {
+        Executor::GetCurrentContext().m_token.ThrowIfCancelled();
 
-        godot::UtilityFunctions::print(__FILE__, ":", __LINE__, ": Reading ", size, " bytes of ", filename.c_str(), " file");
+        const auto filename = buffer->GetFilename();
+        const auto size = buffer->GetSize();
 
-        is.seekg(0, std::ios::beg);
-        is.read(reinterpret_cast<char *>(&bytes[0]), size);
-        is.close();
+        MemoryAccounting::AddLevelMonitor(filename);
 
-        StreamReader streamReader{ bytes };
-        ProcessChunk(streamReader);
+        SWBF2_LOG(LogLevel::Info, __FILE__, ":", __LINE__, ": Reading ", size, " bytes of ", filename.c_str(), " file");
+
+        if (progress != nullptr)
+        {
+            progress->m_total.store(size, std::memory_order_relaxed);
+        }
+
+        {
+            // unhandled chunks of this file are printed as one line per type when it is done
+            ChunkSummaryScope summary{ filename };
+
+            StreamReader streamReader{ std::move(buffer) };
+            ProcessChunk(streamReader, progress);
+        }
+
+        if (progress != nullptr)
+        {
+            progress->m_done.store(size, std::memory_order_relaxed);
+        }
 
-        godot::UtilityFunctions::print(__FILE__, ":", __LINE__, ": Finished reading ", bytes.size(), " bytes of ", filename.c_str(), " file");
+        SWBF2_LOG(LogLevel::Info, __FILE__, ":", __LINE__, ": Finished reading ", size, " bytes of ", filename.c_str(), " file");
+        return true;
     }
 
     void UcfbChunk::ProcessChunk(StreamReader &streamReader)
     {
-        godot::UtilityFunctions::print(__FILE__, ":", __LINE__, ": Processing chunk ", streamReader.GetHeader().ToString().c_str(), " with size ", streamReader.GetHeader().size, ", eof ", streamReader.IsEof());
+        ProcessChunk(streamReader, nullptr);
+    }
+
+    void UcfbChunk::ProcessChunk(StreamReader &streamReader, ReadProgress *progress)
+    {
+        char name[ChunkHeader::FORMATTED_SIZE];
+        SWBF2_LOG(LogLevel::Verbose, __FILE__, ":", __LINE__, ": Processing chunk ", streamReader.GetHeader().Format(name), " with size ", streamReader.GetHeader().size, ", eof ", streamReader.IsEof());
 
         std::vector<std::pair<StreamReader, StreamReader>> children_parents;
         children_parents.reserve(64);
 
-        while (!streamReader.IsEof()) {
-            auto streamReaderChild = streamReader.ReadChild();
-            if (streamReaderChild)
-                children_parents.emplace_back(*streamReaderChild, streamReader);
+        std::optional<StreamReader> streamReaderChild;
+        while ((streamReaderChild = streamReader.ReadChild()).has_value()) {
+            if (LoadProfiles::IsSkipped(streamReader.GetHeader().m_Magic, streamReaderChild->GetHeader().m_Magic))
+            {
+                AddProgress(progress, *streamReaderChild);
+                continue;
+            }
+
+            children_parents.emplace_back(*streamReaderChild, streamReader);
+        }
+
+        // Small chunks are batched per dependency set and handed out first, big ones
+        // follow largest first so they don't end up last on one core. The graph
+        // holds back chunks until the chunks producing their inputs are done.
+        auto dependencies = [&](std::size_t i)
+            {
+                const auto *processor = ChunkProcessor::Find(children_parents[i].first.GetHeader().m_Magic);
+                return processor ? std::pair{ processor->m_produces, processor->m_consumes } : std::pair{ LoadResource::None, LoadResource::None };
+            };
+
+        std::vector<std::size_t> big;
+        std::vector<std::vector<std::size_t>> batches;
+        std::map<std::pair<LoadResource, LoadResource>, std::pair<std::size_t, std::size_t>> openBatches; // dependencies -> batch, bytes
+
+        for (std::size_t i = 0; i < children_parents.size(); ++i)
+        {
+            const auto size = children_parents[i].first.GetHeader().size;
+            if (size >= SMALL_CHUNK_BYTES)
+            {
+                big.push_back(i);
+                continue;
+            }
+
+            auto it = openBatches.find(dependencies(i));
+            if (it == openBatches.end() || it->second.second + size > SMALL_CHUNK_BYTES)
+            {
+                batches.emplace_back();
+                it = openBatches.insert_or_assign(dependencies(i), std::pair{ batches.size() - 1, std::size_t{ 0 } }).first;
+            }
+
+            batches[it->second.first].push_back(i);
+            it->second.second += size;
+        }
+
+        std::stable_sort(big.begin(), big.end(), [&](std::size_t a, std::size_t b)
+            {
+                return children_parents[a].first.GetHeader().size > children_parents[b].first.GetHeader().size;
+            });
+
+        LoadGraph graph;
+
+        for (const auto &batch : batches)
+        {
+            const auto [produces, consumes] = dependencies(batch.front());
+
+            graph.Add(produces, consumes, [&children_parents, &batch, progress]
+                {
+                    for (auto i : batch)
+                    {
+                        auto &[reader1, reader2] = children_parents[i];
+                        ChunkProcessor::ProcessChunk(reader1, reader2);
+                        AddProgress(progress, reader1);
+                    }
+                });
         }
 
-        for (auto &[reader1, reader2] : children_parents) {
-            ChunkProcessor::ProcessChunk(reader1, reader2);
+        for (auto i : big)
+        {
+            const auto [produces, consumes] = dependencies(i);
+
+            graph.Add(produces, consumes, [&children_parents, i, progress]
+                {
+                    auto &[reader1, reader2] = children_parents[i];
+                    ChunkProcessor::ProcessChunk(reader1, reader2);
+                    AddProgress(progress, reader1);
+                });
         }
+
+        graph.Run();
     }
 }
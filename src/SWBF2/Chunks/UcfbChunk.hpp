@@ -1,16 +1,31 @@
 #pragma once
 
+#include <atomic>
+
 #include "ChunkHeader.hpp"
+#include "FileBuffer.hpp"
 
 namespace SWBF2
 {
+    class StreamReader;
+
+    // Bytes of a file's top level chunks that finished, skipped ones count as finished
+    typedef struct _READ_PROGRESS
+    {
+        std::atomic<std::size_t> m_total{ 0 };
+        std::atomic<std::size_t> m_done{ 0 };
+    } ReadProgress;
+
     class UcfbChunk {
     public:
-        using ChunkProcessingFunction = std::function<void(StreamReader &streamReader)>;
+        static constexpr ChunkSize SMALL_CHUNK_BYTES = 64 * 1024;
 
-        static inline const std::unordered_map<uint32_t, ChunkProcessingFunction> m_functions{};
-
-        static void ReadUcfbFile(const std::string &filename);
+        // Throws LoadCancelled once the current task context's token is cancelled
+        static bool ReadUcfbFile(const std::string &filename, ReadProgress *progress = nullptr);
+        static bool ReadUcfbFile(std::shared_ptr<const FileBuffer> buffer, ReadProgress *progress = nullptr);
         static void ProcessChunk(StreamReader &streamReader);
+
+    private:
+        static void ProcessChunk(StreamReader &streamReader, ReadProgress *progress);
     };
 }
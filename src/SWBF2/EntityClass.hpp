@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include "PropertyStore.hpp"
+
+namespace SWBF2
+{
+    enum class EntityClassType : uint32_t {
+        GameObject, // entc
+        Ordnance,   // ordc
+        Weapon,     // wpnc
+        Explosion,  // expc
+    };
+
+    class EntityClass {
+    public:
+        std::string m_name;  // TYPE
+        std::string m_base;  // BASE, the class properties fall back to
+        EntityClassType m_type;
+        std::string m_level; // file the class was read from
+
+        PropertyStore m_properties;
+    };
+}
@@ -0,0 +1,161 @@
+#include "EntityClasses.hpp"
+
+namespace SWBF2
+{
+    namespace
+    {
+        // a BASE chain longer than this is taken as a cycle
+        constexpr std::size_t MAX_BASE_DEPTH = 32;
+
+        template <typename FindFunction>
+        std::optional<std::string_view> FollowBase(const EntityClass &entityClass, FNVHash key, FindFunction find)
+        {
+            const EntityClass *current = &entityClass;
+            for (std::size_t depth = 0; current != nullptr && depth < MAX_BASE_DEPTH; ++depth)
+            {
+                if (auto value = current->m_properties.Get(key))
+                {
+                    return value;
+                }
+
+                if (current->m_base.empty())
+                {
+                    break;
+                }
+
+                current = find(FNV::HashConstexpr(current->m_base));
+            }
+
+            return std::nullopt;
+        }
+    }
+
+    std::mutex EntityClasses::m_mutex;
+    std::unordered_map<FNVHash, EntityClass *> EntityClasses::m_classes;
+    std::vector<std::unique_ptr<EntityClass>> EntityClasses::m_storage;
+
+    void EntityClasses::Insert(EntityClass &&entityClass)
+    {
+        const auto name = FNV::HashConstexpr(entityClass.m_name);
+
+        std::lock_guard lock{ m_mutex };
+
+        auto current = m_classes.find(name);
+        if (current == m_classes.end())
+        {
+            m_storage.push_back(std::make_unique<EntityClass>(std::move(entityClass)));
+            m_classes.emplace(name, m_storage.back().get());
+            return;
+        }
+
+        // a level read again replaces its own copy, in place so pointers to it stay valid
+        EntityClass *stored = current->second->m_level == entityClass.m_level ? current->second : nullptr;
+        for (auto it = m_storage.rbegin(); stored == nullptr && it != m_storage.rend(); ++it)
+        {
+            if ((*it)->m_level == entityClass.m_level && FNV::HashConstexpr((*it)->m_name) == name)
+            {
+                stored = it->get();
+            }
+        }
+
+        if (stored != nullptr)
+        {
+            *stored = std::move(entityClass);
+        }
+        else
+        {
+            m_storage.push_back(std::make_unique<EntityClass>(std::move(entityClass)));
+            stored = m_storage.back().get();
+        }
+
+        current->second = stored;
+    }
+
+    EntityClass *EntityClasses::Find(FNVHash name)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        auto it = m_classes.find(name);
+        return it != m_classes.end() ? it->second : nullptr;
+    }
+
+    EntityClass *EntityClasses::Find(std::string_view name)
+    {
+        return Find(FNV::HashConstexpr(name));
+    }
+
+    std::optional<std::string_view> EntityClasses::GetProperty(const EntityClass &entityClass, FNVHash key)
+    {
+        return FollowBase(entityClass, key, [](FNVHash name) { return Find(name); });
+    }
+
+    bool EntityClasses::SetProperty(FNVHash name, FNVHash key, std::string_view value)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        auto it = m_classes.find(name);
+        if (it == m_classes.end())
+        {
+            return false;
+        }
+
+        it->second->m_properties.Set(key, value);
+        return true;
+    }
+
+    std::optional<std::string> EntityClasses::CopyProperty(FNVHash name, FNVHash key)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        auto find = [](FNVHash name) -> const EntityClass *
+            {
+                auto it = m_classes.find(name);
+                return it != m_classes.end() ? it->second : nullptr;
+            };
+
+        const auto *entityClass = find(name);
+        if (entityClass == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        auto value = FollowBase(*entityClass, key, find);
+        return value ? std::optional<std::string>{ *value } : std::nullopt;
+    }
+
+    std::size_t EntityClasses::GetCount()
+    {
+        std::lock_guard lock{ m_mutex };
+        return m_classes.size();
+    }
+
+    void EntityClasses::RemoveLevel(const std::string &level)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        std::erase_if(m_classes, [&](const auto &entry)
+            {
+                return entry.second->m_level == level;
+            });
+
+        // a class of another level may have been shadowed by one of this level
+        std::erase_if(m_storage, [&](const auto &entityClass)
+            {
+                return entityClass->m_level == level;
+            });
+
+        // the latest read of a name wins, as it did on Insert
+        for (auto it = m_storage.rbegin(); it != m_storage.rend(); ++it)
+        {
+            m_classes.try_emplace(FNV::HashConstexpr((*it)->m_name), it->get());
+        }
+    }
+
+    void EntityClasses::Clear()
+    {
+        std::lock_guard lock{ m_mutex };
+
+        m_classes.clear();
+        m_storage.clear();
+    }
+}
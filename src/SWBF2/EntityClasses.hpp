@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include "Types.hpp"
+
+#include "EntityClass.hpp"
+
+namespace SWBF2
+{
+    // ODF classes by the FNV hash of their name. A class read again, from
+    // a later level, replaces the earlier one for lookups. Read again from
+    // the same level it overwrites its old copy. Classes stay where they are
+    // until their level is removed, so pointers handed to gameplay code don't move.
+    class EntityClasses {
+    public:
+        static void Insert(EntityClass &&entityClass);
+
+        static EntityClass *Find(FNVHash name);
+        static EntityClass *Find(std::string_view name);
+
+        // Falls back along the BASE classes
+        static std::optional<std::string_view> GetProperty(const EntityClass &entityClass, FNVHash key);
+
+        // Find and GetProperty hand out the stored classes, for the loading threads and
+        // code that does not run alongside loads. These two work under the registry
+        // lock and may be used from any thread.
+        static bool SetProperty(FNVHash name, FNVHash key, std::string_view value); // false for unknown classes
+        static std::optional<std::string> CopyProperty(FNVHash name, FNVHash key);  // falls back like GetProperty
+
+        static std::size_t GetCount();
+
+        static void RemoveLevel(const std::string &level); // drops every class read from the level file
+        static void Clear();
+
+    private:
+        static std::mutex m_mutex;
+        static std::unordered_map<FNVHash, EntityClass *> m_classes;
+        static std::vector<std::unique_ptr<EntityClass>> m_storage;
+    };
+}
@@ -0,0 +1,443 @@
+#include <algorithm>
+
+#include "Chunks/StreamReader.hpp"
+#include "Chunks/UcfbChunk.hpp"
+#include "Threading/ThreadPool.hpp"
+
+#include "EntityClasses.hpp"
+#include "LevelLoader.hpp"
+#include "Logging.hpp"
+#include "Models.hpp"
+
+namespace SWBF2
+{
+    namespace
+    {
+        double ElapsedMilliseconds(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+        {
+            return std::chrono::duration<double, std::milli>(end - start).count();
+        }
+
+        // Name and offset of every modl chunk, only reads the NAME child of each
+        void IndexModels(StreamReader &streamReader, std::vector<std::pair<std::string, std::size_t>> &models)
+        {
+            std::optional<StreamReader> readerChild;
+            while ((readerChild = streamReader.ReadChild()).has_value())
+            {
+                switch (readerChild->GetHeader().m_Magic)
+                {
+                    case "ucfb"_m:
+                        IndexModels(*readerChild, models);
+                        break;
+
+                    case "modl"_m: {
+                        auto nameReaderChild = readerChild->ReadChildWithHeader<"NAME"_m>();
+                        if (nameReaderChild)
+                        {
+                            std::string name;
+                            *nameReaderChild >> name;
+                            models.emplace_back(std::move(name), readerChild->GetOffset());
+                        }
+                        break;
+                    }
+
+                    default:
+                        break;
+                }
+            }
+        }
+    }
+
+    std::mutex LevelLoader::m_mutex;
+    std::vector<std::weak_ptr<LoadRequest>> LevelLoader::m_requests;
+    LoaderStats LevelLoader::m_stats{};
+
+    LoadRequest::LoadRequest(const std::string &filename, TaskPriority priority, LoadFinishedFunction onFinished)
+        : m_filename(filename), m_priority(priority), m_token(CancellationToken::Create()), m_onFinished(std::move(onFinished))
+    {
+    }
+
+    const std::string &LoadRequest::GetFilename() const
+    {
+        return m_filename;
+    }
+
+    TaskPriority LoadRequest::GetPriority() const
+    {
+        return m_priority;
+    }
+
+    LoadStatus LoadRequest::GetStatus() const
+    {
+        return m_status;
+    }
+
+    bool LoadRequest::IsDone() const
+    {
+        const auto status = GetStatus();
+        return status != LoadStatus::Queued && status != LoadStatus::Loading;
+    }
+
+    double LoadRequest::GetMilliseconds() const
+    {
+        return ElapsedMilliseconds(m_start, m_end);
+    }
+
+    double LoadRequest::GetProgress() const
+    {
+        if (m_status.load() == LoadStatus::Finished)
+        {
+            return 1.0;
+        }
+
+        const auto total = m_progress.m_total.load(std::memory_order_relaxed);
+        return total != 0 ? std::min(1.0, static_cast<double>(m_progress.m_done.load(std::memory_order_relaxed)) / total) : 0.0;
+    }
+
+    void LoadRequest::Cancel()
+    {
+        m_token.Cancel();
+    }
+
+    void LoadRequest::Wait()
+    {
+        while (!IsDone())
+        {
+            if (Executor::GetDefault().RunPendingTask())
+            {
+                continue;
+            }
+
+            std::unique_lock lock{ m_mutex };
+            m_condition.wait_for(lock, std::chrono::milliseconds(1), [this] { return IsDone(); });
+        }
+    }
+
+    void LoadRequest::SetStatus(LoadStatus status)
+    {
+        {
+            std::lock_guard lock{ m_mutex };
+            m_status = status;
+        }
+
+        m_condition.notify_all();
+    }
+
+    LoadBatch::LoadBatch(const std::vector<std::string> &filenames, TaskPriority priority)
+        : m_priority(priority), m_token(CancellationToken::Create())
+    {
+        std::vector<std::string> unique;
+        for (const auto &filename : filenames)
+        {
+            // a file read twice in a row gives the same assets
+            if (std::ranges::find(unique, filename) == unique.end())
+            {
+                unique.push_back(filename);
+            }
+        }
+
+        for (const auto &filename : unique)
+        {
+            m_requests.push_back(std::make_shared<LoadRequest>(filename, priority));
+        }
+    }
+
+    const std::vector<std::shared_ptr<LoadRequest>> &LoadBatch::GetRequests() const
+    {
+        return m_requests;
+    }
+
+    LoadStatus LoadBatch::GetStatus() const
+    {
+        auto has = [this](LoadStatus status)
+            {
+                return std::ranges::any_of(m_requests, [status](const auto &request) { return request->GetStatus() == status; });
+            };
+
+        if (!IsDone())
+        {
+            return has(LoadStatus::Loading) ? LoadStatus::Loading : LoadStatus::Queued;
+        }
+
+        if (has(LoadStatus::Cancelled))
+        {
+            return LoadStatus::Cancelled;
+        }
+
+        return has(LoadStatus::Failed) ? LoadStatus::Failed : LoadStatus::Finished;
+    }
+
+    bool LoadBatch::IsDone() const
+    {
+        return std::ranges::all_of(m_requests, [](const auto &request) { return request->IsDone(); });
+    }
+
+    void LoadBatch::Cancel()
+    {
+        m_token.Cancel();
+
+        for (const auto &request : m_requests)
+        {
+            request->Cancel();
+        }
+    }
+
+    void LoadBatch::Wait()
+    {
+        for (const auto &request : m_requests)
+        {
+            request->Wait();
+        }
+    }
+
+    BatchLoadStats LoadBatch::GetStats() const
+    {
+        BatchLoadStats stats{};
+        stats.m_planMilliseconds = m_planMilliseconds;
+        stats.m_duplicateModels = m_index ? m_index->GetDuplicates() : 0;
+
+        double slowest = 0.0;
+        for (const auto &request : m_requests)
+        {
+            const auto milliseconds = request->GetMilliseconds();
+            slowest = std::max(slowest, milliseconds);
+            stats.m_serialMilliseconds += milliseconds;
+            stats.m_totalMilliseconds = std::max(stats.m_totalMilliseconds, ElapsedMilliseconds(m_start, request->m_end));
+        }
+
+        stats.m_criticalPathMilliseconds = m_planMilliseconds + slowest;
+        return stats;
+    }
+
+    std::shared_ptr<LoadRequest> LevelLoader::Load(const std::string &filename, TaskPriority priority, LoadFinishedFunction onFinished)
+    {
+        auto request = std::make_shared<LoadRequest>(filename, priority, std::move(onFinished));
+
+        {
+            std::lock_guard lock{ m_mutex };
+
+            std::erase_if(m_requests, [](const auto &request) { return request.expired(); });
+            m_requests.push_back(request);
+            ++m_stats.m_requested;
+        }
+
+        Executor::GetDefault().Submit([request] { Run(request); }, priority);
+
+        return request;
+    }
+
+    std::shared_ptr<LoadBatch> LevelLoader::LoadAll(const std::vector<std::string> &filenames, TaskPriority priority, LoadFinishedFunction onFinished)
+    {
+        auto batch = std::make_shared<LoadBatch>(filenames, priority);
+        batch->m_start = std::chrono::steady_clock::now();
+
+        // no file would ever finish to report an empty batch
+        if (batch->m_requests.empty())
+        {
+            if (onFinished)
+            {
+                onFinished(LoadStatus::Finished);
+            }
+
+            return batch;
+        }
+
+        if (onFinished)
+        {
+            // the last file to finish reports the batch, requests don't keep the batch alive
+            auto remaining = std::make_shared<std::atomic<std::size_t>>(batch->m_requests.size());
+            auto onRequestFinished = [weak = std::weak_ptr{ batch }, remaining, onFinished = std::move(onFinished)](LoadStatus)
+                {
+                    if (--*remaining != 0)
+                    {
+                        return;
+                    }
+
+                    if (auto batch = weak.lock())
+                    {
+                        onFinished(batch->GetStatus());
+                    }
+                };
+
+            for (const auto &request : batch->m_requests)
+            {
+                request->m_onFinished = onRequestFinished;
+            }
+        }
+
+        {
+            std::lock_guard lock{ m_mutex };
+
+            std::erase_if(m_requests, [](const auto &request) { return request.expired(); });
+            for (const auto &request : batch->m_requests)
+            {
+                m_requests.push_back(request);
+                ++m_stats.m_requested;
+            }
+        }
+
+        Executor::GetDefault().Submit([batch] { Plan(batch); }, priority);
+
+        return batch;
+    }
+
+    void LevelLoader::CancelAll()
+    {
+        std::lock_guard lock{ m_mutex };
+
+        for (const auto &weak : m_requests)
+        {
+            if (auto request = weak.lock())
+            {
+                request->Cancel();
+            }
+        }
+    }
+
+    LoaderStats LevelLoader::GetStats()
+    {
+        std::lock_guard lock{ m_mutex };
+
+        return m_stats;
+    }
+
+    void LevelLoader::Plan(const std::shared_ptr<LoadBatch> &batch)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const auto &requests = batch->m_requests;
+
+        std::vector<std::vector<std::pair<std::string, std::size_t>>> models(requests.size());
+
+        try
+        {
+            ScopedTaskContext scope{ { batch->m_priority, batch->m_token } };
+
+            TaskGroup tasks;
+            for (std::size_t i = 0; i < requests.size(); ++i)
+            {
+                tasks.Run([&requests, &models, i]
+                    {
+                        auto &request = *requests[i];
+                        request.m_token.ThrowIfCancelled();
+
+                        request.m_buffer = FileBuffer::Open(request.m_filename);
+                        if (request.m_buffer)
+                        {
+                            StreamReader streamReader{ request.m_buffer };
+                            IndexModels(streamReader, models[i]);
+                        }
+                    });
+            }
+
+            tasks.Wait();
+        }
+        catch (const LoadCancelled &)
+        {
+        }
+        catch (const std::exception &e)
+        {
+            SWBF2_LOG(LogLevel::Error, __FILE__, ":", __LINE__, ": failed index batch: ", e.what());
+        }
+
+        // files in batch order, chunks in file order, so the provider is the one read last
+        std::vector<std::string> filenames;
+        for (const auto &request : requests)
+        {
+            filenames.push_back(request->m_filename);
+        }
+
+        auto index = std::make_shared<BatchIndex>(std::move(filenames), batch->m_token);
+        for (std::size_t i = 0; i < requests.size(); ++i)
+        {
+            for (const auto &[name, offset] : models[i])
+            {
+                index->AddModel(name, i, offset);
+            }
+        }
+
+        batch->m_index = index;
+        for (const auto &request : requests)
+        {
+            request->m_batchIndex = index;
+        }
+
+        batch->m_planMilliseconds = ElapsedMilliseconds(start, std::chrono::steady_clock::now());
+
+        for (const auto &request : requests)
+        {
+            Executor::GetDefault().Submit([request] { Run(request); }, batch->m_priority);
+        }
+    }
+
+    void LevelLoader::Run(const std::shared_ptr<LoadRequest> &request)
+    {
+        auto status = LoadStatus::Failed;
+        request->m_start = std::chrono::steady_clock::now();
+
+        try
+        {
+            ScopedTaskContext scope{ { request->m_priority, request->m_token, request->m_batchIndex } };
+
+            request->SetStatus(LoadStatus::Loading);
+
+            auto buffer = std::exchange(request->m_buffer, nullptr);
+            const auto read = buffer ? UcfbChunk::ReadUcfbFile(std::move(buffer), &request->m_progress) : UcfbChunk::ReadUcfbFile(request->m_filename, &request->m_progress);
+            status = read ? LoadStatus::Finished : LoadStatus::Failed;
+        }
+        catch (const LoadCancelled &)
+        {
+            status = LoadStatus::Cancelled;
+        }
+        catch (const std::exception &e)
+        {
+            SWBF2_LOG(LogLevel::Error, __FILE__, ":", __LINE__, ": failed load ", request->m_filename.c_str(), ": ", e.what());
+        }
+
+        // copies in other files of the batch take over what this file no longer provides
+        if (request->m_batchIndex && (status == LoadStatus::Cancelled || status == LoadStatus::Failed))
+        {
+            request->m_batchIndex->OnFileFailed(request->m_filename, status == LoadStatus::Cancelled);
+        }
+
+        // a load cancelled after it finished reading keeps its models
+        if (status == LoadStatus::Cancelled)
+        {
+            Models::RemoveLevel(request->m_filename);
+            EntityClasses::RemoveLevel(request->m_filename);
+        }
+
+        // drops a buffer a cancelled batch opened but never read
+        request->m_buffer.reset();
+
+        {
+            std::lock_guard lock{ m_mutex };
+
+            switch (status)
+            {
+                case LoadStatus::Finished:
+                    ++m_stats.m_finished;
+                    break;
+
+                case LoadStatus::Cancelled: {
+                    const auto latency = request->m_token.GetMillisecondsSinceCancel();
+                    ++m_stats.m_cancelled;
+                    m_stats.m_cancelLatencyTotalMilliseconds += latency;
+                    m_stats.m_cancelLatencyMaxMilliseconds = std::max(m_stats.m_cancelLatencyMaxMilliseconds, latency);
+                    break;
+                }
+
+                default:
+                    ++m_stats.m_failed;
+                    break;
+            }
+        }
+
+        request->m_end = std::chrono::steady_clock::now();
+        request->SetStatus(status);
+
+        if (request->m_onFinished)
+        {
+            request->m_onFinished(status);
+        }
+    }
+}
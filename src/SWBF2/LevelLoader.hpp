@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "Types.hpp"
+
+#include "BatchIndex.hpp"
+
+#include "Chunks/FileBuffer.hpp"
+#include "Chunks/UcfbChunk.hpp"
+#include "Threading/Executor.hpp"
+
+namespace SWBF2
+{
+    enum class LoadStatus : uint32_t {
+        Queued,
+        Loading,
+        Finished,
+        Cancelled,
+        Failed,
+    };
+
+    typedef struct _LOADER_STATS
+    {
+        uint64_t m_requested;
+        uint64_t m_finished;
+        uint64_t m_cancelled;
+        uint64_t m_failed;
+        double m_cancelLatencyTotalMilliseconds; // Cancel until the load released its work
+        double m_cancelLatencyMaxMilliseconds;
+    } LoaderStats;
+
+    typedef struct _BATCH_LOAD_STATS
+    {
+        double m_totalMilliseconds;        // batch start until its last file finished
+        double m_criticalPathMilliseconds; // planning plus the slowest file
+        double m_planMilliseconds;         // opening and indexing every file
+        double m_serialMilliseconds;       // sum of the file load times
+        std::size_t m_duplicateModels;     // model chunks skipped because a later chunk provides the name
+    } BatchLoadStats;
+
+    using LoadFinishedFunction = std::function<void(LoadStatus status)>;
+
+    // One lvl file load running on the default executor
+    class LoadRequest {
+    public:
+        LoadRequest(const std::string &filename, TaskPriority priority, LoadFinishedFunction onFinished = {});
+
+        const std::string &GetFilename() const;
+        TaskPriority GetPriority() const;
+        LoadStatus GetStatus() const;
+        bool IsDone() const;
+        double GetMilliseconds() const; // time spent loading, valid once done
+        double GetProgress() const;     // 0 to 1, by bytes of top level chunks read
+
+        // The load stops at the next chunk boundary and drops what it already read
+        void Cancel();
+
+        // Runs queued tasks while waiting, so it may be called from any thread
+        void Wait();
+
+    private:
+        friend class LevelLoader;
+        friend class LoadBatch;
+
+        void SetStatus(LoadStatus status);
+
+        std::string m_filename;
+        TaskPriority m_priority;
+        CancellationToken m_token;
+        std::atomic<LoadStatus> m_status{ LoadStatus::Queued };
+        ReadProgress m_progress;
+
+        LoadFinishedFunction m_onFinished; // called on the loading thread once done
+        std::shared_ptr<const FileBuffer> m_buffer; // opened while a batch is planned
+        std::shared_ptr<BatchIndex> m_batchIndex; // handed to the chunks through the task context
+        std::chrono::steady_clock::time_point m_start;
+        std::chrono::steady_clock::time_point m_end;
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+    };
+
+    // Files loaded together, like the ReadDataFile calls of a mission script
+    class LoadBatch {
+    public:
+        LoadBatch(const std::vector<std::string> &filenames, TaskPriority priority);
+
+        const std::vector<std::shared_ptr<LoadRequest>> &GetRequests() const;
+        LoadStatus GetStatus() const; // Finished only once every file finished
+        bool IsDone() const;
+
+        void Cancel();
+        void Wait();
+
+        BatchLoadStats GetStats() const; // valid once done
+
+    private:
+        friend class LevelLoader;
+
+        std::vector<std::shared_ptr<LoadRequest>> m_requests;
+        TaskPriority m_priority;
+        CancellationToken m_token;
+
+        std::shared_ptr<BatchIndex> m_index;
+        std::chrono::steady_clock::time_point m_start;
+        double m_planMilliseconds = 0.0;
+    };
+
+    // Asynchronous level loads with a priority and cancellation. Work of a
+    // cancelled load is unwound at the next chunk boundary, its buffers are
+    // released and the models it read are removed from the cache.
+    //
+    // A batch first opens and indexes all its files in parallel, then loads
+    // them in parallel on the same executor. A model name found in several
+    // files is only decoded from the chunk that would win when the files were
+    // read one after another, the last one.
+    class LevelLoader {
+    public:
+        // onFinished runs on the thread that finished the load, for a batch once every file
+        // is done. An empty batch is finished at once and reports on the calling thread.
+        static std::shared_ptr<LoadRequest> Load(const std::string &filename, TaskPriority priority = TaskPriority::Visible, LoadFinishedFunction onFinished = {});
+        static std::shared_ptr<LoadBatch> LoadAll(const std::vector<std::string> &filenames, TaskPriority priority = TaskPriority::Visible, LoadFinishedFunction onFinished = {});
+        static void CancelAll();
+        static LoaderStats GetStats();
+
+    private:
+        static void Plan(const std::shared_ptr<LoadBatch> &batch);
+        static void Run(const std::shared_ptr<LoadRequest> &request);
+
+        static std::mutex m_mutex;
+        static std::vector<std::weak_ptr<LoadRequest>> m_requests; // in flight
+        static LoaderStats m_stats;
+    };
+}
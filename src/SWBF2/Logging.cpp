@@ -0,0 +1,339 @@
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <godot_cpp/classes/os.hpp>
+
+#include "Logging.hpp"
+
+#include "Chunks/ChunkHeader.hpp"
+#include "Threading/CompletionQueue.hpp"
+
+namespace SWBF2
+{
+    namespace
+    {
+        constexpr auto SINK_WAKE_INTERVAL = std::chrono::milliseconds(100); // a missed wake-up costs at most this
+        constexpr auto SINK_DRAIN_BUDGET = std::chrono::milliseconds(50);
+        constexpr auto SUMMARY_INTERVAL = std::chrono::seconds(1);
+
+        typedef struct _FILE_CHUNK_COUNTS
+        {
+            std::map<uint32_t, uint64_t> m_counts; // magic -> chunks
+            uint32_t m_scopes = 0;                 // reads of the file in flight
+        } FileChunkCounts;
+
+        typedef struct _LOGGING_STATE
+        {
+            CompletionQueue m_queue; // the sink thread is its only consumer
+
+            std::mutex m_mutex; // sink start, stop and wake-up
+            std::condition_variable m_wake;
+            std::thread m_thread;
+            bool m_stop = false;
+            bool m_closed = false; // set by Shutdown, no sink is started again
+            std::atomic<bool> m_running{ false };
+
+            std::mutex m_countsMutex;
+            std::map<std::string, FileChunkCounts, std::less<>> m_counts;
+
+            std::atomic<int> m_level{ -1 }; // -1 until set, see GetLevel
+
+            std::atomic<uint64_t> m_written{ 0 };
+            std::atomic<uint64_t> m_suppressed{ 0 };
+            std::atomic<uint64_t> m_chunksCounted{ 0 };
+        } LoggingState;
+
+        LoggingState &GetState()
+        {
+            static LoggingState state;
+            return state;
+        }
+
+        void Print(LogLevel level, const godot::String &message)
+        {
+            switch (level)
+            {
+                case LogLevel::Verbose:
+                case LogLevel::Info:
+                    godot::UtilityFunctions::print(message);
+                    break;
+                case LogLevel::Warning:
+                    godot::UtilityFunctions::push_warning(message);
+                    break;
+                case LogLevel::Error:
+                default:
+                    godot::UtilityFunctions::printerr(message);
+                    break;
+            }
+        }
+
+        // Caller holds m_countsMutex
+        void WriteSummary(const std::string &filename, const FileChunkCounts &counts)
+        {
+            for (const auto &[magic, count] : counts.m_counts)
+            {
+                ChunkHeader header;
+                header.m_Magic = magic;
+
+                char name[ChunkHeader::FORMATTED_SIZE];
+                Logging::Write(LogLevel::Warning, godot::UtilityFunctions::str(filename.c_str(), ": ", static_cast<int64_t>(count), " ", header.Format(name), " chunks not implemented"));
+            }
+        }
+
+        // Summaries of files no longer being read, their counts come from lazy decodes
+        void WriteIdleSummaries()
+        {
+            auto &state = GetState();
+            std::lock_guard lock{ state.m_countsMutex };
+
+            for (auto it = state.m_counts.begin(); it != state.m_counts.end();)
+            {
+                if (it->second.m_scopes != 0)
+                {
+                    ++it;
+                    continue;
+                }
+
+                WriteSummary(it->first, it->second);
+                it = state.m_counts.erase(it);
+            }
+        }
+
+        void RunSink()
+        {
+            auto &state = GetState();
+            auto lastSummary = std::chrono::steady_clock::now();
+
+            while (true)
+            {
+                bool stop;
+                {
+                    std::unique_lock lock{ state.m_mutex };
+                    state.m_wake.wait_for(lock, SINK_WAKE_INTERVAL, [&state] { return state.m_stop || state.m_queue.GetDepth() != 0; });
+                    stop = state.m_stop;
+                }
+
+                const auto now = std::chrono::steady_clock::now();
+                if (now - lastSummary >= SUMMARY_INTERVAL)
+                {
+                    WriteIdleSummaries();
+                    lastSummary = now;
+                }
+
+                if (state.m_queue.GetDepth() != 0)
+                {
+                    state.m_queue.Drain(SINK_DRAIN_BUDGET);
+                }
+
+                if (stop && state.m_queue.GetDepth() == 0)
+                {
+                    return;
+                }
+            }
+        }
+
+        // false once shut down
+        bool StartSink()
+        {
+            auto &state = GetState();
+            if (state.m_running.load(std::memory_order_acquire))
+            {
+                return true;
+            }
+
+            std::lock_guard lock{ state.m_mutex };
+            if (state.m_running.load(std::memory_order_relaxed))
+            {
+                return true;
+            }
+
+            if (state.m_closed)
+            {
+                return false;
+            }
+
+            state.m_stop = false;
+            state.m_thread = std::thread(RunSink);
+            state.m_running.store(true, std::memory_order_release);
+            return true;
+        }
+    }
+
+    bool LogSite::Allow(uint64_t &suppressed)
+    {
+        const int64_t second = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        // whoever moves the window resets the count, a few messages racing the reset may slip through
+        auto window = m_window.load(std::memory_order_relaxed);
+        if (window != second && m_window.compare_exchange_strong(window, second, std::memory_order_relaxed))
+        {
+            m_count.store(0, std::memory_order_relaxed);
+        }
+
+        if (m_count.fetch_add(1, std::memory_order_relaxed) >= MESSAGES_PER_SECOND)
+        {
+            m_suppressed.fetch_add(1, std::memory_order_relaxed);
+            GetState().m_suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool Logging::IsVerbose()
+    {
+        static const bool verbose = godot::OS::get_singleton()->is_stdout_verbose();
+        return verbose;
+    }
+
+    bool Logging::IsEnabled(LogLevel level)
+    {
+        return level >= GetLevel();
+    }
+
+    void Logging::SetLevel(LogLevel level)
+    {
+        GetState().m_level = static_cast<int>(level);
+    }
+
+    LogLevel Logging::GetLevel()
+    {
+        const int level = GetState().m_level;
+        if (level < 0)
+        {
+            return IsVerbose() ? LogLevel::Verbose : LogLevel::Info;
+        }
+
+        return static_cast<LogLevel>(level);
+    }
+
+    void Logging::Write(LogLevel level, godot::String message, uint64_t suppressed)
+    {
+        if (suppressed != 0)
+        {
+            message += godot::UtilityFunctions::str(" (", static_cast<int64_t>(suppressed), " similar messages suppressed)");
+        }
+
+        // a thread started now would never be joined
+        if (!StartSink())
+        {
+            return;
+        }
+
+        auto &state = GetState();
+        ++state.m_written;
+
+        state.m_queue.Push([level, message = std::move(message)]
+            {
+                Print(level, message);
+            });
+
+        // not under the lock so a parse thread never waits on the sink, a wake-up
+        // missed this way is picked up by the sink's interval
+        state.m_wake.notify_one();
+    }
+
+    void Logging::CountUnhandledChunk(std::string_view filename, uint32_t magic)
+    {
+        if (!IsEnabled(LogLevel::Warning))
+        {
+            return;
+        }
+
+        auto &state = GetState();
+        ++state.m_chunksCounted;
+
+        std::lock_guard lock{ state.m_countsMutex };
+
+        auto it = state.m_counts.find(filename);
+        if (it == state.m_counts.end())
+        {
+            it = state.m_counts.emplace(std::string(filename), FileChunkCounts{}).first;
+        }
+
+        ++it->second.m_counts[magic];
+    }
+
+    LogStats Logging::GetStats()
+    {
+        auto &state = GetState();
+        return { state.m_written, state.m_suppressed, state.m_chunksCounted, state.m_queue.GetDepth() };
+    }
+
+    void Logging::Shutdown()
+    {
+        auto &state = GetState();
+
+        {
+            std::lock_guard lock{ state.m_countsMutex };
+
+            for (const auto &[filename, counts] : state.m_counts)
+            {
+                WriteSummary(filename, counts);
+            }
+
+            state.m_counts.clear();
+        }
+
+        {
+            std::lock_guard lock{ state.m_mutex };
+            state.m_closed = true;
+
+            if (!state.m_running)
+            {
+                return;
+            }
+
+            state.m_stop = true;
+        }
+
+        state.m_wake.notify_one();
+        state.m_thread.join();
+
+        // written while the sink was stopping, nobody else consumes the queue now
+        while (state.m_queue.GetDepth() != 0)
+        {
+            state.m_queue.Drain(SINK_DRAIN_BUDGET);
+        }
+
+        state.m_running = false;
+    }
+
+    void Logging::BeginSummary(const std::string &filename)
+    {
+        auto &state = GetState();
+        std::lock_guard lock{ state.m_countsMutex };
+
+        ++state.m_counts[filename].m_scopes;
+    }
+
+    void Logging::EndSummary(const std::string &filename)
+    {
+        auto &state = GetState();
+        std::lock_guard lock{ state.m_countsMutex };
+
+        auto it = state.m_counts.find(filename);
+        if (it == state.m_counts.end() || --it->second.m_scopes != 0)
+        {
+            return;
+        }
+
+        WriteSummary(it->first, it->second);
+        state.m_counts.erase(it);
+    }
+
+    ChunkSummaryScope::ChunkSummaryScope(std::string filename)
+        : m_filename(std::move(filename))
+    {
+        Logging::BeginSummary(m_filename);
+    }
+
+    ChunkSummaryScope::~ChunkSummaryScope()
+    {
+        Logging::EndSummary(m_filename);
+    }
+}
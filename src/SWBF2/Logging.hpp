@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include "Types.hpp"
+
+namespace SWBF2
+{
+    enum class LogLevel : uint8_t {
+        Verbose,
+        Info,
+        Warning,
+        Error,
+    };
+
+    typedef struct _LOG_STATS
+    {
+        uint64_t m_written;       // messages handed to the sink
+        uint64_t m_suppressed;    // dropped by rate limits
+        uint64_t m_chunksCounted; // unhandled chunks folded into summaries
+        std::size_t m_pending;    // messages the sink has not printed yet
+    } LogStats;
+
+    // One per SWBF2_LOG call site. Lets MESSAGES_PER_SECOND through and counts
+    // the rest, so a site hit by every segment of a level prints a handful of
+    // lines and a note of how many were dropped.
+    class LogSite {
+    public:
+        static constexpr uint32_t MESSAGES_PER_SECOND = 10;
+
+        // suppressed is set to the messages dropped since the last one let through
+        bool Allow(uint64_t &suppressed);
+
+    private:
+        std::atomic<int64_t> m_window{ -1 }; // steady clock second
+        std::atomic<uint32_t> m_count{ 0 };
+        std::atomic<uint64_t> m_suppressed{ 0 };
+    };
+
+    // Messages are printed by a background sink thread, a parse thread only
+    // pushes to a lock-free queue. Unhandled chunks are only counted and end
+    // up as one summary line per chunk type per file.
+    class Logging {
+    public:
+        // --verbose can't change while running, so this is read once
+        static bool IsVerbose();
+
+        static bool IsEnabled(LogLevel level);
+        static void SetLevel(LogLevel level);
+        static LogLevel GetLevel(); // Verbose with --verbose, Info otherwise until set
+
+        static void Write(LogLevel level, godot::String message, uint64_t suppressed = 0);
+
+        // Counts a chunk nobody handles, summarized when filename's reads finish
+        static void CountUnhandledChunk(std::string_view filename, uint32_t magic);
+
+        static LogStats GetStats();
+
+        // Prints the pending summaries and queued messages, then stops the sink.
+        // Messages written after it are dropped.
+        static void Shutdown();
+
+    private:
+        friend class ChunkSummaryScope;
+
+        static void BeginSummary(const std::string &filename);
+        static void EndSummary(const std::string &filename);
+    };
+
+    // Held while a file is read, counts for it are printed when the last scope ends.
+    // Counts from reads outside a scope, like lazy model decodes, are printed by the sink.
+    class ChunkSummaryScope {
+    public:
+        explicit ChunkSummaryScope(std::string filename);
+        ~ChunkSummaryScope();
+
+        ChunkSummaryScope(const ChunkSummaryScope &) = delete;
+        ChunkSummaryScope &operator=(const ChunkSummaryScope &) = delete;
+
+    private:
+        std::string m_filename;
+    };
+}
+
+// Arguments are only evaluated, and chunk headers only formatted, when the
+// level is enabled and the call site is under its rate limit
+#define SWBF2_LOG(level, ...)                                                                              \
+    do                                                                                                     \
+    {                                                                                                      \
+        if (::SWBF2::Logging::IsEnabled(level))                                                            \
+        {                                                                                                  \
+            static ::SWBF2::LogSite site;                                                                  \
+            uint64_t suppressed = 0;                                                                       \
+            if (site.Allow(suppressed))                                                                    \
+            {                                                                                              \
+                ::SWBF2::Logging::Write(level, godot::UtilityFunctions::str(__VA_ARGS__), suppressed);     \
+            }                                                                                              \
+        }                                                                                                  \
+    } while (false)
@@ -0,0 +1,204 @@
+
+#include <mutex>
+#include <utility>
+
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+
+#include "MemoryAccounting.hpp"
+#include "Models.hpp"
+
+namespace SWBF2
+{
+    namespace
+    {
+        typedef struct _ACCOUNTING_STATE
+        {
+            std::mutex m_mutex;
+            std::unordered_map<std::string, std::size_t> m_bufferBytes; // level -> source file bytes held
+            std::vector<godot::StringName> m_monitors;
+        } AccountingState;
+
+        AccountingState &GetState()
+        {
+            static AccountingState state;
+            return state;
+        }
+
+        int64_t GetLevelMonitorBytes(const godot::String &level)
+        {
+            auto usage = MemoryAccounting::GetLevelUsage(level.utf8().get_data());
+            return usage ? static_cast<int64_t>(usage->m_bufferBytes + usage->m_modelBytes) : 0;
+        }
+
+        void AddLevelMonitorDeferred(const godot::String &level)
+        {
+            godot::StringName id = "SWBF2/" + level.get_file() + " bytes";
+
+            auto *performance = godot::Performance::get_singleton();
+            if (performance->has_custom_monitor(id))
+            {
+                return;
+            }
+
+            performance->add_custom_monitor(id, callable_mp_static(&GetLevelMonitorBytes).bind(level));
+
+            auto &state = GetState();
+            std::lock_guard lock{ state.m_mutex };
+
+            state.m_monitors.push_back(id);
+        }
+    }
+
+    const char *MemoryAccounting::GetStreamName(AttributeStream stream)
+    {
+        switch (stream)
+        {
+            case AttributeStream::Indices: return "indices";
+            case AttributeStream::Positions: return "positions";
+            case AttributeStream::Normals: return "normals";
+            case AttributeStream::Tangents: return "tangents";
+            case AttributeStream::BiTangents: return "bitangents";
+            case AttributeStream::Colors: return "colors";
+            case AttributeStream::TexCoords: return "texcoords";
+            case AttributeStream::BoneIndices: return "bone_indices";
+            case AttributeStream::Weights: return "weights";
+            default: return "unknown";
+        }
+    }
+
+    void MemoryAccounting::OnBufferAllocated(const std::string &level, std::size_t bytes)
+    {
+        auto &state = GetState();
+        std::lock_guard lock{ state.m_mutex };
+
+        state.m_bufferBytes[level] += bytes;
+    }
+
+    void MemoryAccounting::OnBufferReleased(const std::string &level, std::size_t bytes)
+    {
+        auto &state = GetState();
+        std::lock_guard lock{ state.m_mutex };
+
+        // a buffer outliving Clear has nothing left to subtract from
+        auto it = state.m_bufferBytes.find(level);
+        if (it != state.m_bufferBytes.end())
+        {
+            it->second -= bytes;
+        }
+    }
+
+    void MemoryAccounting::SetLevelBudget(const std::string &level, std::size_t bytes)
+    {
+        Models::SetLevelBudget(level, bytes);
+    }
+
+    void MemoryAccounting::AddLevelMonitor(const std::string &level)
+    {
+        callable_mp_static(&AddLevelMonitorDeferred).bind(godot::String{ level.c_str() }).call_deferred();
+    }
+
+    void MemoryAccounting::RemoveLevelMonitors()
+    {
+        std::vector<godot::StringName> monitors;
+        {
+            auto &state = GetState();
+            std::lock_guard lock{ state.m_mutex };
+
+            monitors = std::exchange(state.m_monitors, {});
+        }
+
+        auto *performance = godot::Performance::get_singleton();
+        for (const auto &monitor : monitors)
+        {
+            if (performance->has_custom_monitor(monitor))
+            {
+                performance->remove_custom_monitor(monitor);
+            }
+        }
+    }
+
+    void MemoryAccounting::Clear()
+    {
+        RemoveLevelMonitors();
+
+        auto &state = GetState();
+        std::lock_guard lock{ state.m_mutex };
+
+        state.m_bufferBytes.clear();
+    }
+
+    std::vector<ModelMemoryUsage> MemoryAccounting::GetModelUsage()
+    {
+        return Models::GetMemoryUsage();
+    }
+
+    std::vector<LevelMemoryUsage> MemoryAccounting::GetLevelUsage()
+    {
+        std::unordered_map<std::string, LevelMemoryUsage> levels;
+
+        for (auto &usage : Models::GetLevelUsage())
+        {
+            levels[usage.m_level] = std::move(usage);
+        }
+
+        {
+            auto &state = GetState();
+            std::lock_guard lock{ state.m_mutex };
+
+            for (const auto &[name, bytes] : state.m_bufferBytes)
+            {
+                auto &level = levels[name];
+                level.m_level = name;
+                level.m_bufferBytes = bytes;
+            }
+        }
+
+        std::vector<LevelMemoryUsage> result;
+        result.reserve(levels.size());
+
+        for (auto &[name, level] : levels)
+        {
+            result.push_back(std::move(level));
+        }
+
+        return result;
+    }
+
+    std::optional<LevelMemoryUsage> MemoryAccounting::GetLevelUsage(const std::string &level)
+    {
+        auto usage = Models::GetLevelUsage(level);
+
+        auto &state = GetState();
+        std::lock_guard lock{ state.m_mutex };
+
+        auto it = state.m_bufferBytes.find(level);
+        if (it == state.m_bufferBytes.end())
+        {
+            return usage;
+        }
+
+        if (!usage)
+        {
+            usage = LevelMemoryUsage{ level, 0, 0, 0, 0, {} };
+        }
+
+        usage->m_bufferBytes = it->second;
+        return usage;
+    }
+
+    std::size_t MemoryAccounting::GetTotalBytes()
+    {
+        std::size_t result = Models::GetStats().m_residentBytes;
+
+        auto &state = GetState();
+        std::lock_guard lock{ state.m_mutex };
+
+        for (const auto &[name, bytes] : state.m_bufferBytes)
+        {
+            result += bytes;
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,68 @@
+
+#pragma once
+
+#include <array>
+
+#include "Types.hpp"
+
+namespace SWBF2
+{
+    enum class AttributeStream : uint32_t {
+        Indices,
+        Positions,
+        Normals,
+        Tangents,
+        BiTangents,
+        Colors,
+        TexCoords,
+        BoneIndices,
+        Weights,
+
+        Count
+    };
+
+    typedef std::array<std::size_t, static_cast<std::size_t>(AttributeStream::Count)> StreamMemoryUsage;
+
+    typedef struct _MODEL_MEMORY_USAGE
+    {
+        std::string m_name;
+        std::string m_level;
+        bool m_resident;
+        std::size_t m_bytes;
+        StreamMemoryUsage m_streams;
+    } ModelMemoryUsage;
+
+    typedef struct _LEVEL_MEMORY_USAGE
+    {
+        std::string m_level;
+        std::size_t m_bufferBytes; // source file bytes held in memory
+        std::size_t m_modelBytes;
+        std::size_t m_modelCount;
+        std::size_t m_budgetBytes;
+        StreamMemoryUsage m_streams;
+    } LevelMemoryUsage;
+
+    // Bytes held per loaded lvl, per model and per attribute stream. Model
+    // figures are running totals kept by the model cache, so they follow
+    // evictions. A level budget evicts that level's models beyond it.
+    class MemoryAccounting {
+    public:
+        static const char *GetStreamName(AttributeStream stream);
+
+        static void OnBufferAllocated(const std::string &level, std::size_t bytes);
+        static void OnBufferReleased(const std::string &level, std::size_t bytes);
+        static void SetLevelBudget(const std::string &level, std::size_t bytes); // 0 means unlimited
+
+        // Performance monitors of each read level. Adding one is deferred to
+        // the main thread, so loader threads may call it.
+        static void AddLevelMonitor(const std::string &level);
+        static void RemoveLevelMonitors();
+
+        static void Clear(); // removes the monitors and forgets every level
+
+        static std::vector<ModelMemoryUsage> GetModelUsage();
+        static std::vector<LevelMemoryUsage> GetLevelUsage();
+        static std::optional<LevelMemoryUsage> GetLevelUsage(const std::string &level);
+        static std::size_t GetTotalBytes();
+    };
+}
@@ -8,4 +8,33 @@ namespace SWBF2
     Model::Model()
     {
     }
+
+    std::size_t Model::GetMemoryUsage() const
+    {
+        std::size_t result = sizeof(Model) + m_name.capacity() + m_node.capacity();
+        result += m_segments.capacity() * sizeof(ModelSegment);
+
+        for (auto bytes : GetStreamMemoryUsage())
+        {
+            result += bytes;
+        }
+
+        return result;
+    }
+
+    StreamMemoryUsage Model::GetStreamMemoryUsage() const
+    {
+        StreamMemoryUsage result{};
+
+        for (const auto &segment : m_segments)
+        {
+            const auto usage = segment.GetMemoryUsage();
+            for (std::size_t i = 0; i < result.size(); ++i)
+            {
+                result[i] += usage[i];
+            }
+        }
+
+        return result;
+    }
 }
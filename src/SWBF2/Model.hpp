@@ -22,6 +22,9 @@ namespace SWBF2
         Model();
         ~Model() = default;
 
+        std::size_t GetMemoryUsage() const;
+        StreamMemoryUsage GetStreamMemoryUsage() const;
+
         std::string m_name;
         std::string m_node;
         ModelInfo m_info;
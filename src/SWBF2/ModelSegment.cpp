@@ -0,0 +1,30 @@
+
+#include "ModelSegment.hpp"
+
+namespace SWBF2
+{
+    StreamMemoryUsage ModelSegment::GetMemoryUsage() const
+    {
+        auto bytesOf = [](const auto &vec)
+            {
+                return vec.capacity() * sizeof(vec[0]);
+            };
+
+        auto set = [](StreamMemoryUsage &usage, AttributeStream stream, std::size_t bytes)
+            {
+                usage[static_cast<std::size_t>(stream)] = bytes;
+            };
+
+        StreamMemoryUsage result{};
+        set(result, AttributeStream::Indices, bytesOf(m_indicesBuf.m_indices));
+        set(result, AttributeStream::Positions, bytesOf(m_verticesBuf.m_positions));
+        set(result, AttributeStream::Normals, bytesOf(m_verticesBuf.m_normals));
+        set(result, AttributeStream::Tangents, bytesOf(m_verticesBuf.m_tangents));
+        set(result, AttributeStream::BiTangents, bytesOf(m_verticesBuf.m_biTangents));
+        set(result, AttributeStream::Colors, bytesOf(m_verticesBuf.m_colors));
+        set(result, AttributeStream::TexCoords, bytesOf(m_verticesBuf.m_texCoords));
+        set(result, AttributeStream::BoneIndices, bytesOf(m_verticesBuf.m_boneIndices));
+        set(result, AttributeStream::Weights, bytesOf(m_verticesBuf.m_weights));
+        return result;
+    }
+}
@@ -4,6 +4,7 @@
 #include "Types.hpp"
 
 #include "Material.hpp"
+#include "MemoryAccounting.hpp"
 
 namespace SWBF2
 {
@@ -69,5 +70,7 @@ namespace SWBF2
         VerticesBuf m_verticesBuf;
         std::string m_parent;
         std::string m_tag;
+
+        StreamMemoryUsage GetMemoryUsage() const;
     };
 }
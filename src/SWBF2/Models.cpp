@@ -1,9 +1,506 @@
 
 #include "Types.hpp"
 
+#include "Chunks/ModelChunk.hpp"
+
+#include "Logging.hpp"
 #include "Models.hpp"
 
 namespace SWBF2
 {
-    std::unordered_map<std::string, Model> Models::m_models;
+    std::mutex Models::m_mutex;
+    std::unordered_map<std::string, Models::Entry> Models::m_models;
+    std::list<std::string> Models::m_lru;
+    ModelCacheStats Models::m_stats{};
+    std::unordered_map<std::string, LevelMemoryUsage> Models::m_levels;
+    std::atomic<ModelDecodeMode> Models::m_decodeMode{ ModelDecodeMode::Eager };
+    std::unordered_map<std::string, ModelRetention> Models::m_retention;
+    ModelRetention Models::m_defaultRetention = ModelRetention::KeepAll;
+    std::shared_ptr<const std::function<void(const std::string &name)>> Models::m_observer;
+    std::shared_ptr<const std::function<void(const std::string &name)>> Models::m_removeObserver;
+
+    void Models::Insert(Model &&model, const ModelSource &source)
+    {
+        std::unique_lock lock{ m_mutex };
+
+        auto name = model.m_name;
+        auto &entry = m_models[name];
+        if (IsShadowed(entry, source))
+        {
+            return;
+        }
+
+        // level totals follow the source, so drop the old copy before switching it
+        if (entry.m_model)
+        {
+            Evict(entry);
+        }
+
+        entry.m_source = source;
+        entry.m_info = model.m_info;
+
+        MakeResident(name, entry, std::make_shared<const Model>(std::move(model)));
+        EvictToBudget();
+        EvictToLevelBudget(source.m_filename);
+
+        auto observer = m_observer;
+        lock.unlock();
+
+        if (observer)
+        {
+            (*observer)(name);
+        }
+    }
+
+    void Models::InsertLazy(const std::string &name, const ModelInfo &info, const ModelSource &source)
+    {
+        std::unique_lock lock{ m_mutex };
+
+        auto &entry = m_models[name];
+        if (IsShadowed(entry, source))
+        {
+            return;
+        }
+
+        if (entry.m_model)
+        {
+            Evict(entry);
+        }
+
+        entry.m_source = source;
+        entry.m_info = info;
+
+        auto observer = m_observer;
+        lock.unlock();
+
+        if (observer)
+        {
+            (*observer)(name);
+        }
+    }
+
+    std::shared_ptr<const Model> Models::Get(const std::string &name, ModelDetail detail)
+    {
+        std::unique_lock lock{ m_mutex };
+
+        auto it = m_models.find(name);
+        if (it == m_models.end())
+        {
+            return nullptr;
+        }
+
+        auto &entry = it->second;
+        if (entry.m_model && (detail == ModelDetail::Any || !entry.m_released))
+        {
+            ++m_stats.m_hits;
+            m_lru.splice(m_lru.begin(), m_lru, entry.m_lru);
+            return entry.m_model;
+        }
+
+        ++m_stats.m_misses;
+
+        // someone else is already decoding this model, wait for their result
+        if (entry.m_pending.valid())
+        {
+            auto pending = entry.m_pending;
+            lock.unlock();
+            return pending.get();
+        }
+
+        std::promise<std::shared_ptr<const Model>> promise;
+        entry.m_pending = promise.get_future().share();
+
+        const auto source = entry.m_source;
+        lock.unlock();
+
+        std::shared_ptr<const Model> result;
+        try
+        {
+            auto model = ModelChunk::ReadModel(source);
+            if (model)
+            {
+                result = std::make_shared<const Model>(std::move(*model));
+            }
+        }
+        catch (const std::exception &e)
+        {
+            SWBF2_LOG(LogLevel::Error, __FILE__, ":", __LINE__, ": failed decode ", name.c_str(), ": ", e.what());
+        }
+
+        lock.lock();
+
+        it = m_models.find(name);
+        if (it != m_models.end())
+        {
+            it->second.m_pending = {};
+
+            if (result && (!it->second.m_model || it->second.m_released))
+            {
+                MakeResident(name, it->second, result);
+                EvictToBudget();
+                EvictToLevelBudget(it->second.m_source.m_filename);
+            }
+        }
+
+        lock.unlock();
+
+        promise.set_value(result);
+        return result;
+    }
+
+    std::optional<ModelInfo> Models::GetInfo(const std::string &name)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        auto it = m_models.find(name);
+        if (it == m_models.end())
+        {
+            return std::nullopt;
+        }
+
+        return it->second.m_info;
+    }
+
+    bool Models::Contains(const std::string &name)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        return m_models.contains(name);
+    }
+
+    void Models::SetRetention(const std::string &name, ModelRetention retention)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        m_retention.insert_or_assign(name, retention);
+    }
+
+    void Models::SetDefaultRetention(ModelRetention retention)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        m_defaultRetention = retention;
+    }
+
+    void Models::OnUploaded(const std::string &name, const std::shared_ptr<const Model> &uploaded)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        // the cache may have evicted or replaced the uploaded copy in the meantime
+        auto it = m_models.find(name);
+        if (it == m_models.end() || it->second.m_model != uploaded || it->second.m_released)
+        {
+            return;
+        }
+
+        auto retentionIt = m_retention.find(name);
+        auto retention = retentionIt != m_retention.end() ? retentionIt->second : m_defaultRetention;
+        if (retention == ModelRetention::KeepAll)
+        {
+            return;
+        }
+
+        const auto &model = *it->second.m_model;
+
+        auto reduced = std::make_shared<Model>();
+        reduced->m_name = model.m_name;
+        reduced->m_node = model.m_node;
+        reduced->m_info = model.m_info;
+        reduced->m_segments.reserve(model.m_segments.size());
+
+        for (const auto &segment : model.m_segments)
+        {
+            auto &copy = reduced->m_segments.emplace_back();
+            copy.m_info = segment.m_info;
+            copy.m_material = segment.m_material;
+            copy.p_renderType = segment.p_renderType;
+            copy.m_parent = segment.m_parent;
+            copy.m_tag = segment.m_tag;
+            copy.m_indicesBuf.m_indicesCount = segment.m_indicesBuf.m_indicesCount;
+            copy.m_verticesBuf.m_verticesCount = segment.m_verticesBuf.m_verticesCount;
+            copy.m_verticesBuf.m_stride = segment.m_verticesBuf.m_stride;
+            copy.m_verticesBuf.m_flags = segment.m_verticesBuf.m_flags;
+
+            if (retention == ModelRetention::KeepCollision)
+            {
+                copy.m_indicesBuf.m_indices = segment.m_indicesBuf.m_indices;
+                copy.m_verticesBuf.m_positions = segment.m_verticesBuf.m_positions;
+            }
+        }
+
+        MakeResident(name, it->second, std::move(reduced));
+        it->second.m_released = true;
+    }
+
+    void Models::SetDecodeMode(ModelDecodeMode mode)
+    {
+        m_decodeMode = mode;
+    }
+
+    ModelDecodeMode Models::GetDecodeMode()
+    {
+        return m_decodeMode;
+    }
+
+    void Models::SetMemoryBudget(std::size_t bytes)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        m_stats.m_budgetBytes = bytes;
+        EvictToBudget();
+    }
+
+    void Models::SetLevelBudget(const std::string &level, std::size_t bytes)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        auto &usage = m_levels[level];
+        usage.m_level = level;
+        usage.m_budgetBytes = bytes;
+        EvictToLevelBudget(level);
+    }
+
+    ModelCacheStats Models::GetStats()
+    {
+        std::lock_guard lock{ m_mutex };
+
+        auto stats = m_stats;
+        stats.m_modelCount = m_models.size();
+        stats.m_residentCount = m_lru.size();
+        return stats;
+    }
+
+    std::vector<ModelMemoryUsage> Models::GetMemoryUsage()
+    {
+        std::lock_guard lock{ m_mutex };
+
+        std::vector<ModelMemoryUsage> result;
+        result.reserve(m_models.size());
+
+        for (const auto &[name, entry] : m_models)
+        {
+            result.push_back({ name, entry.m_source.m_filename, entry.m_model != nullptr, entry.m_bytes, entry.m_streams });
+        }
+
+        return result;
+    }
+
+    std::optional<LevelMemoryUsage> Models::GetLevelUsage(const std::string &level)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        auto it = m_levels.find(level);
+        if (it == m_levels.end())
+        {
+            return std::nullopt;
+        }
+
+        return it->second;
+    }
+
+    std::vector<LevelMemoryUsage> Models::GetLevelUsage()
+    {
+        std::lock_guard lock{ m_mutex };
+
+        std::vector<LevelMemoryUsage> result;
+        result.reserve(m_levels.size());
+
+        for (const auto &[name, usage] : m_levels)
+        {
+            result.push_back(usage);
+        }
+
+        return result;
+    }
+
+    void Models::SetInsertObserver(std::function<void(const std::string &name)> observer)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        m_observer = observer ? std::make_shared<const std::function<void(const std::string &name)>>(std::move(observer)) : nullptr;
+    }
+
+    void Models::SetRemoveObserver(std::function<void(const std::string &name)> observer)
+    {
+        std::lock_guard lock{ m_mutex };
+
+        m_removeObserver = observer ? std::make_shared<const std::function<void(const std::string &name)>>(std::move(observer)) : nullptr;
+    }
+
+    void Models::RemoveLevel(const std::string &level)
+    {
+        std::unique_lock lock{ m_mutex };
+
+        std::vector<std::string> removed;
+        for (auto it = m_models.begin(); it != m_models.end();)
+        {
+            if (it->second.m_source.m_filename != level)
+            {
+                ++it;
+                continue;
+            }
+
+            if (it->second.m_model)
+            {
+                Evict(it->second);
+            }
+
+            removed.push_back(it->first);
+            it = m_models.erase(it);
+        }
+
+        auto observer = m_removeObserver;
+        lock.unlock();
+
+        NotifyRemoved(observer, removed);
+    }
+
+    void Models::Clear()
+    {
+        std::unique_lock lock{ m_mutex };
+
+        std::vector<std::string> removed;
+        if (m_removeObserver)
+        {
+            for (const auto &[name, entry] : m_models)
+            {
+                removed.push_back(name);
+            }
+        }
+
+        m_models.clear();
+        m_lru.clear();
+        m_stats.m_residentBytes = 0;
+
+        // budgets outlive the models they limit
+        for (auto &[name, usage] : m_levels)
+        {
+            usage = { name, 0, 0, 0, usage.m_budgetBytes, {} };
+        }
+
+        auto observer = m_removeObserver;
+        lock.unlock();
+
+        NotifyRemoved(observer, removed);
+    }
+
+    void Models::NotifyRemoved(const std::shared_ptr<const std::function<void(const std::string &name)>> &observer, const std::vector<std::string> &names)
+    {
+        if (!observer)
+        {
+            return;
+        }
+
+        for (const auto &name : names)
+        {
+            (*observer)(name);
+        }
+    }
+
+    bool Models::IsShadowed(const Entry &entry, const ModelSource &source)
+    {
+        // chunks of one file may be processed in any order, the last one in the file wins
+        return entry.m_source.m_filename == source.m_filename && entry.m_source.m_offset > source.m_offset;
+    }
+
+    void Models::MakeResident(const std::string &name, Entry &entry, std::shared_ptr<const Model> model)
+    {
+        auto &level = m_levels[entry.m_source.m_filename];
+        level.m_level = entry.m_source.m_filename;
+
+        if (entry.m_model)
+        {
+            m_stats.m_residentBytes -= entry.m_bytes;
+            m_lru.erase(entry.m_lru);
+
+            level.m_modelBytes -= entry.m_bytes;
+            level.m_modelCount--;
+            for (std::size_t i = 0; i < level.m_streams.size(); ++i)
+            {
+                level.m_streams[i] -= entry.m_streams[i];
+            }
+        }
+
+        entry.m_model = std::move(model);
+        entry.m_bytes = entry.m_model->GetMemoryUsage();
+        entry.m_streams = entry.m_model->GetStreamMemoryUsage();
+        entry.m_lru = m_lru.insert(m_lru.begin(), name);
+        entry.m_released = false;
+
+        m_stats.m_residentBytes += entry.m_bytes;
+
+        level.m_modelBytes += entry.m_bytes;
+        level.m_modelCount++;
+        for (std::size_t i = 0; i < level.m_streams.size(); ++i)
+        {
+            level.m_streams[i] += entry.m_streams[i];
+        }
+    }
+
+    void Models::Evict(Entry &entry)
+    {
+        m_stats.m_residentBytes -= entry.m_bytes;
+        m_lru.erase(entry.m_lru);
+
+        auto &level = m_levels[entry.m_source.m_filename];
+        level.m_modelBytes -= entry.m_bytes;
+        level.m_modelCount--;
+        for (std::size_t i = 0; i < level.m_streams.size(); ++i)
+        {
+            level.m_streams[i] -= entry.m_streams[i];
+        }
+
+        entry.m_model.reset();
+        entry.m_released = false;
+        entry.m_bytes = 0;
+        entry.m_streams = {};
+    }
+
+    void Models::EvictToBudget()
+    {
+        if (m_stats.m_budgetBytes == 0)
+        {
+            return;
+        }
+
+        // never evict the most recently used model, even if it alone exceeds the budget
+        while (m_stats.m_residentBytes > m_stats.m_budgetBytes && m_lru.size() > 1)
+        {
+            Evict(m_models.at(m_lru.back()));
+            ++m_stats.m_evictions;
+        }
+    }
+
+    void Models::EvictToLevelBudget(const std::string &level)
+    {
+        auto levelIt = m_levels.find(level);
+        if (levelIt == m_levels.end() || levelIt->second.m_budgetBytes == 0)
+        {
+            return;
+        }
+
+        const auto &usage = levelIt->second;
+
+        // least recently used models of the level first, never the most recently used model
+        auto it = m_lru.end();
+        while (usage.m_modelBytes > usage.m_budgetBytes && it != m_lru.begin())
+        {
+            auto current = std::prev(it);
+            if (current == m_lru.begin())
+            {
+                break;
+            }
+
+            auto &entry = m_models.at(*current);
+            if (entry.m_source.m_filename == level)
+            {
+                Evict(entry);
+                ++m_stats.m_evictions;
+            }
+            else
+            {
+                it = current;
+            }
+        }
+    }
 }
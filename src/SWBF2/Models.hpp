@@ -1,14 +1,117 @@
 
 #pragma once
 
+#include <atomic>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+
 #include "Types.hpp"
 
+#include "Chunks/FileBuffer.hpp"
+
+#include "MemoryAccounting.hpp"
 #include "Model.hpp"
 
 namespace SWBF2
 {
+    typedef struct _MODEL_SOURCE
+    {
+        std::string m_filename;
+        std::size_t m_offset; // offset of the modl header in the file
+        ChunkSize m_size;
+        std::shared_ptr<const FileBuffer> m_buffer; // only kept while the file is mapped
+    } ModelSource;
+
+    typedef struct _MODEL_CACHE_STATS
+    {
+        uint64_t m_hits;
+        uint64_t m_misses;
+        uint64_t m_evictions;
+        std::size_t m_residentBytes;
+        std::size_t m_budgetBytes;
+        std::size_t m_modelCount;
+        std::size_t m_residentCount;
+    } ModelCacheStats;
+
+    enum class ModelDecodeMode : uint32_t {
+        Eager,  // decode segments while the lvl is read
+        Lazy,   // only record name, INFO and chunk span, decode on first Get
+    };
+
+    enum class ModelRetention : uint32_t {
+        KeepAll,            // keep the full CPU copy after upload
+        ReleaseAfterUpload, // drop vertex and index data once the mesh is uploaded
+        KeepCollision,      // keep only positions and indices for collision and picking
+    };
+
+    enum class ModelDetail : uint32_t {
+        Any,  // whatever is resident, may have been reduced after upload
+        Full, // all vertex attributes, decoded again if they were released
+    };
+
+    // Decoded models, kept within a memory budget. Evicted models only keep
+    // their source chunk location and are decoded again on the next Get.
     class Models {
     public:
-        static std::unordered_map<std::string, Model> m_models;
+        static void Insert(Model &&model, const ModelSource &source);
+        static void InsertLazy(const std::string &name, const ModelInfo &info, const ModelSource &source);
+        static std::shared_ptr<const Model> Get(const std::string &name, ModelDetail detail = ModelDetail::Any);
+        static std::optional<ModelInfo> GetInfo(const std::string &name);
+        static bool Contains(const std::string &name);
+
+        static void SetRetention(const std::string &name, ModelRetention retention);
+        static void SetDefaultRetention(ModelRetention retention);
+        static void OnUploaded(const std::string &name, const std::shared_ptr<const Model> &uploaded); // ignored unless uploaded is the cached copy
+
+        static void SetDecodeMode(ModelDecodeMode mode);
+        static ModelDecodeMode GetDecodeMode();
+
+        static void SetMemoryBudget(std::size_t bytes); // 0 means unlimited
+        static void SetLevelBudget(const std::string &level, std::size_t bytes); // 0 means unlimited
+        static ModelCacheStats GetStats();
+        static std::vector<ModelMemoryUsage> GetMemoryUsage();
+        static std::optional<LevelMemoryUsage> GetLevelUsage(const std::string &level); // m_bufferBytes is left 0
+        static std::vector<LevelMemoryUsage> GetLevelUsage();
+        // Called on the inserting thread for every model a level read adds, outside the cache lock
+        static void SetInsertObserver(std::function<void(const std::string &name)> observer);
+        // Called for every model RemoveLevel or Clear drops, outside the cache lock. Evicted
+        // models stay known, Get decodes them again.
+        static void SetRemoveObserver(std::function<void(const std::string &name)> observer);
+
+        static void RemoveLevel(const std::string &level); // drops every model read from the level file
+        static void Clear();
+
+    private:
+        struct Entry
+        {
+            std::shared_ptr<const Model> m_model; // nullptr while evicted
+            std::shared_future<std::shared_ptr<const Model>> m_pending; // valid while being decoded
+            ModelSource m_source;
+            ModelInfo m_info{};
+            bool m_released = false; // resident model had its CPU copy reduced after upload
+            std::size_t m_bytes = 0;
+            StreamMemoryUsage m_streams{};
+            std::list<std::string>::iterator m_lru;
+        };
+
+        static bool IsShadowed(const Entry &entry, const ModelSource &source);
+        static void NotifyRemoved(const std::shared_ptr<const std::function<void(const std::string &name)>> &observer, const std::vector<std::string> &names);
+        static void MakeResident(const std::string &name, Entry &entry, std::shared_ptr<const Model> model);
+        static void Evict(Entry &entry);
+        static void EvictToBudget();
+        static void EvictToLevelBudget(const std::string &level);
+
+        static std::mutex m_mutex;
+        static std::unordered_map<std::string, Entry> m_models;
+        static std::list<std::string> m_lru; // most recently used first
+        static ModelCacheStats m_stats;
+        static std::unordered_map<std::string, LevelMemoryUsage> m_levels; // running totals of resident models per source file
+        static std::atomic<ModelDecodeMode> m_decodeMode;
+        static std::unordered_map<std::string, ModelRetention> m_retention;
+        static ModelRetention m_defaultRetention;
+        static std::shared_ptr<const std::function<void(const std::string &name)>> m_observer;
+        static std::shared_ptr<const std::function<void(const std::string &name)>> m_removeObserver;
     };
 }
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <bit>
+#include <charconv>
+
+#include "PropertyStore.hpp"
+
+namespace SWBF2
+{
+    namespace
+    {
+        constexpr std::size_t MIN_SLOTS = 16;
+
+        // FNV hashes are already well mixed, the low bits pick the slot
+        std::size_t GetSlotIndex(FNVHash key, std::size_t mask)
+        {
+            return key & mask;
+        }
+
+        std::string_view Trim(std::string_view text)
+        {
+            const auto first = text.find_first_not_of(" \t\r\n");
+            if (first == std::string_view::npos)
+            {
+                return {};
+            }
+
+            return text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+        }
+    }
+
+    void PropertyStore::Set(FNVHash key, std::string_view value)
+    {
+        if ((m_keyCount + 1) * 2 > m_slots.size())
+        {
+            Grow();
+        }
+
+        const std::size_t mask = m_slots.size() - 1;
+
+        std::size_t index = GetSlotIndex(key, mask);
+        while (m_slots[index].m_value != EMPTY && m_slots[index].m_key != key)
+        {
+            index = (index + 1) & mask;
+        }
+
+        auto &slot = m_slots[index];
+        if (slot.m_value == EMPTY)
+        {
+            slot.m_key = key;
+            ++m_keyCount;
+        }
+
+        m_values.push_back({ static_cast<uint32_t>(m_text.size()), static_cast<uint32_t>(value.size()), slot.m_value });
+        m_text.append(value);
+
+        slot.m_value = static_cast<uint32_t>(m_values.size() - 1);
+    }
+
+    void PropertyStore::Reserve(std::size_t count)
+    {
+        m_values.reserve(count);
+
+        const std::size_t slots = std::bit_ceil(std::max(count * 2, MIN_SLOTS));
+        while (m_slots.size() < slots)
+        {
+            Grow();
+        }
+    }
+
+    bool PropertyStore::Contains(FNVHash key) const
+    {
+        return FindSlot(key) != nullptr;
+    }
+
+    std::optional<std::string_view> PropertyStore::Get(FNVHash key) const
+    {
+        const auto *slot = FindSlot(key);
+        if (slot == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        const auto &value = m_values[slot->m_value];
+        return std::string_view{ m_text }.substr(value.m_offset, value.m_length);
+    }
+
+    std::vector<std::string_view> PropertyStore::GetAll(FNVHash key) const
+    {
+        std::vector<std::string_view> result;
+
+        const auto *slot = FindSlot(key);
+        for (uint32_t index = slot != nullptr ? slot->m_value : EMPTY; index != EMPTY; index = m_values[index].m_previous)
+        {
+            result.push_back(std::string_view{ m_text }.substr(m_values[index].m_offset, m_values[index].m_length));
+        }
+
+        std::ranges::reverse(result);
+        return result;
+    }
+
+    std::optional<int64_t> PropertyStore::GetInt(FNVHash key) const
+    {
+        const auto text = Get(key);
+        if (!text)
+        {
+            return std::nullopt;
+        }
+
+        const auto trimmed = Trim(*text);
+
+        int64_t value = 0;
+        const auto [end, error] = std::from_chars(trimmed.data(), trimmed.data() + trimmed.size(), value);
+        if (error != std::errc{} || trimmed.empty())
+        {
+            return std::nullopt;
+        }
+
+        return value;
+    }
+
+    std::optional<float> PropertyStore::GetFloat(FNVHash key) const
+    {
+        const auto text = Get(key);
+        if (!text)
+        {
+            return std::nullopt;
+        }
+
+        const auto trimmed = Trim(*text);
+
+        float value = 0.0f;
+        const auto [end, error] = std::from_chars(trimmed.data(), trimmed.data() + trimmed.size(), value);
+        if (error != std::errc{} || trimmed.empty())
+        {
+            return std::nullopt;
+        }
+
+        return value;
+    }
+
+    std::optional<bool> PropertyStore::GetBool(FNVHash key) const
+    {
+        const auto text = Get(key);
+        if (!text)
+        {
+            return std::nullopt;
+        }
+
+        // ODF flags are 0 and 1, a few use words
+        const auto trimmed = Trim(*text);
+        if (trimmed == "true")
+        {
+            return true;
+        }
+
+        if (trimmed == "false")
+        {
+            return false;
+        }
+
+        const auto number = GetFloat(key);
+        if (!number)
+        {
+            return std::nullopt;
+        }
+
+        return *number != 0.0f;
+    }
+
+    std::size_t PropertyStore::GetKeyCount() const
+    {
+        return m_keyCount;
+    }
+
+    std::size_t PropertyStore::GetValueCount() const
+    {
+        return m_values.size();
+    }
+
+    const PropertySlot *PropertyStore::FindSlot(FNVHash key) const
+    {
+        if (m_slots.empty())
+        {
+            return nullptr;
+        }
+
+        const std::size_t mask = m_slots.size() - 1;
+
+        // at most half full, a free slot ends every probe
+        for (std::size_t index = GetSlotIndex(key, mask);; index = (index + 1) & mask)
+        {
+            const auto &slot = m_slots[index];
+            if (slot.m_value == EMPTY)
+            {
+                return nullptr;
+            }
+
+            if (slot.m_key == key)
+            {
+                return &slot;
+            }
+        }
+    }
+
+    void PropertyStore::Grow()
+    {
+        std::vector<PropertySlot> slots(std::max(m_slots.size() * 2, MIN_SLOTS), PropertySlot{ 0, EMPTY });
+        const std::size_t mask = slots.size() - 1;
+
+        for (const auto &slot : m_slots)
+        {
+            if (slot.m_value == EMPTY)
+            {
+                continue;
+            }
+
+            std::size_t index = GetSlotIndex(slot.m_key, mask);
+            while (slots[index].m_value != EMPTY)
+            {
+                index = (index + 1) & mask;
+            }
+
+            slots[index] = slot;
+        }
+
+        m_slots = std::move(slots);
+    }
+}
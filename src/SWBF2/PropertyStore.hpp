@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include "Chunks/Hashing.hpp"
+
+namespace SWBF2
+{
+    typedef struct _PROPERTY_SLOT
+    {
+        FNVHash m_key;
+        uint32_t m_value; // index of the latest value, EMPTY for a free slot
+    } PropertySlot;
+
+    typedef struct _PROPERTY_VALUE
+    {
+        uint32_t m_offset; // into the raw text
+        uint32_t m_length;
+        uint32_t m_previous; // earlier value of the same key, or EMPTY
+    } PropertyValue;
+
+    // Properties keyed by the FNV hash of their name, in one flat open
+    // addressing table. A read is a probe and hash compares, names are never
+    // kept. Values stay the raw config text until a typed read parses them.
+    // A key set again keeps its earlier values, like repeated ODF lines.
+    class PropertyStore {
+    public:
+        static constexpr uint32_t EMPTY = UINT32_MAX;
+
+        void Set(FNVHash key, std::string_view value);
+        void Reserve(std::size_t count);
+
+        bool Contains(FNVHash key) const;
+
+        // Views stay valid until the next Set
+        std::optional<std::string_view> Get(FNVHash key) const; // latest value
+        std::vector<std::string_view> GetAll(FNVHash key) const; // in the order they were set
+
+        std::optional<int64_t> GetInt(FNVHash key) const;
+        std::optional<float> GetFloat(FNVHash key) const;
+        std::optional<bool> GetBool(FNVHash key) const;
+
+        std::size_t GetKeyCount() const;
+        std::size_t GetValueCount() const;
+
+    private:
+        const PropertySlot *FindSlot(FNVHash key) const;
+        void Grow();
+
+        std::vector<PropertySlot> m_slots; // power of two, at most half full
+        std::size_t m_keyCount = 0;
+
+        std::vector<PropertyValue> m_values;
+        std::string m_text;
+    };
+}
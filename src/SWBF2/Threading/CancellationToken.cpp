@@ -0,0 +1,49 @@
+
+#include "CancellationToken.hpp"
+
+namespace SWBF2
+{
+    CancellationToken CancellationToken::Create()
+    {
+        CancellationToken token;
+        token.m_state = std::make_shared<State>();
+        return token;
+    }
+
+    void CancellationToken::Cancel() const
+    {
+        if (!m_state || m_state->m_cancelled)
+        {
+            return;
+        }
+
+        // the time is set before the flag, so a cancelled token always has one; the first cancel wins
+        std::chrono::steady_clock::rep expected = 0;
+        m_state->m_cancelTime.compare_exchange_strong(expected, std::chrono::steady_clock::now().time_since_epoch().count());
+        m_state->m_cancelled = true;
+    }
+
+    bool CancellationToken::IsCancelled() const
+    {
+        return m_state && m_state->m_cancelled;
+    }
+
+    void CancellationToken::ThrowIfCancelled() const
+    {
+        if (IsCancelled())
+        {
+            throw LoadCancelled{};
+        }
+    }
+
+    double CancellationToken::GetMillisecondsSinceCancel() const
+    {
+        if (!IsCancelled())
+        {
+            return 0.0;
+        }
+
+        const auto cancelled = std::chrono::steady_clock::time_point{ std::chrono::steady_clock::duration{ m_state->m_cancelTime.load() } };
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cancelled).count();
+    }
+}
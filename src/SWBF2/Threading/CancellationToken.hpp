@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include "../Types.hpp"
+
+namespace SWBF2
+{
+    class LoadCancelled : public std::runtime_error {
+    public:
+        LoadCancelled()
+            : std::runtime_error("load cancelled")
+        {
+        }
+    };
+
+    // Shared cancellation flag of one load. Copies observe the same flag, a
+    // default constructed token is never cancelled.
+    class CancellationToken {
+    public:
+        static CancellationToken Create();
+
+        void Cancel() const;
+        bool IsCancelled() const;
+        void ThrowIfCancelled() const; // throws LoadCancelled
+
+        // Time since Cancel was first called, 0 if it was not
+        double GetMillisecondsSinceCancel() const;
+
+    private:
+        struct State
+        {
+            std::atomic<bool> m_cancelled{ false };
+            std::atomic<std::chrono::steady_clock::rep> m_cancelTime{ 0 };
+        };
+
+        std::shared_ptr<State> m_state;
+    };
+}
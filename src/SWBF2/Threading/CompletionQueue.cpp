@@ -0,0 +1,138 @@
+
+#include "CompletionQueue.hpp"
+
+namespace SWBF2
+{
+    CompletionQueue::CompletionQueue()
+        : m_head(&m_stub), m_tail(&m_stub)
+    {
+    }
+
+    CompletionQueue::~CompletionQueue()
+    {
+        Clear();
+    }
+
+    void CompletionQueue::Push(Task task)
+    {
+        auto *node = new Node;
+        node->m_task = std::move(task);
+
+        ++m_depth;
+        ++m_pushed;
+
+        PushNode(node);
+    }
+
+    std::size_t CompletionQueue::Drain(std::chrono::microseconds budget)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const auto end = start + budget;
+
+        std::size_t count = 0;
+        do
+        {
+            auto *node = PopNode();
+            if (node == nullptr)
+            {
+                break;
+            }
+
+            --m_depth;
+
+            auto task = std::move(node->m_task);
+            delete node;
+
+            task();
+            ++count;
+        } while (std::chrono::steady_clock::now() < end);
+
+        const auto milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        m_drained += count;
+        m_lastDrainCount = count;
+        m_lastDrainMilliseconds = milliseconds;
+        if (milliseconds > m_maxDrainMilliseconds)
+        {
+            m_maxDrainMilliseconds = milliseconds;
+        }
+
+        return count;
+    }
+
+    void CompletionQueue::Clear()
+    {
+        while (auto *node = PopNode())
+        {
+            --m_depth;
+            delete node;
+        }
+    }
+
+    std::size_t CompletionQueue::GetDepth() const
+    {
+        return m_depth;
+    }
+
+    CompletionQueueStats CompletionQueue::GetStats() const
+    {
+        return { m_depth, m_pushed, m_drained, m_lastDrainCount, m_lastDrainMilliseconds, m_maxDrainMilliseconds };
+    }
+
+    CompletionQueue &CompletionQueue::GetMain()
+    {
+        static CompletionQueue queue;
+        return queue;
+    }
+
+    void CompletionQueue::PushNode(Node *node)
+    {
+        node->m_next.store(nullptr, std::memory_order_relaxed);
+
+        // the exchange orders producers, the link makes the node reachable to the consumer
+        auto *previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->m_next.store(node, std::memory_order_release);
+    }
+
+    CompletionQueue::Node *CompletionQueue::PopNode()
+    {
+        auto *tail = m_tail;
+        auto *next = tail->m_next.load(std::memory_order_acquire);
+
+        if (tail == &m_stub)
+        {
+            if (next == nullptr)
+            {
+                return nullptr;
+            }
+
+            m_tail = next;
+            tail = next;
+            next = next->m_next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr)
+        {
+            m_tail = next;
+            return tail;
+        }
+
+        // a producer exchanged the head but did not link its node yet, try again next drain
+        if (tail != m_head.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+
+        // tail is the last node, put the stub behind it so it can be handed out
+        PushNode(&m_stub);
+
+        next = tail->m_next.load(std::memory_order_acquire);
+        if (next != nullptr)
+        {
+            m_tail = next;
+            return tail;
+        }
+
+        return nullptr;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include "Executor.hpp"
+
+namespace SWBF2
+{
+    typedef struct _COMPLETION_QUEUE_STATS
+    {
+        std::size_t m_depth;              // tasks waiting
+        uint64_t m_pushed;
+        uint64_t m_drained;
+        std::size_t m_lastDrainCount;     // tasks run by the last Drain
+        double m_lastDrainMilliseconds;
+        double m_maxDrainMilliseconds;
+    } CompletionQueueStats;
+
+    // Lock-free multi-producer, single-consumer queue of tasks. Loader threads
+    // push work that has to happen on the main thread, like creating Godot
+    // resources, and the main thread runs it in slices of a time budget so a
+    // burst of completions is spread over frames instead of one long hitch.
+    class CompletionQueue {
+    public:
+        CompletionQueue();
+        ~CompletionQueue();
+
+        CompletionQueue(const CompletionQueue &) = delete;
+        CompletionQueue &operator=(const CompletionQueue &) = delete;
+
+        // Any thread
+        void Push(Task task);
+
+        // Consumer thread only. Runs tasks in push order until the budget is spent,
+        // at least one task so the queue always moves; returns the tasks run
+        std::size_t Drain(std::chrono::microseconds budget);
+        void Clear(); // drops the queued tasks without running them
+
+        std::size_t GetDepth() const;
+        CompletionQueueStats GetStats() const;
+
+        static CompletionQueue &GetMain(); // drained by Core
+
+    private:
+        struct Node
+        {
+            std::atomic<Node *> m_next{ nullptr };
+            Task m_task;
+        };
+
+        void PushNode(Node *node);
+        Node *PopNode();
+
+        std::atomic<Node *> m_head; // producers exchange in here
+        Node *m_tail;               // consumer only
+        Node m_stub;
+
+        std::atomic<std::size_t> m_depth{ 0 };
+        std::atomic<uint64_t> m_pushed{ 0 };
+        std::atomic<uint64_t> m_drained{ 0 };
+        std::atomic<std::size_t> m_lastDrainCount{ 0 };
+        std::atomic<double> m_lastDrainMilliseconds{ 0.0 };
+        std::atomic<double> m_maxDrainMilliseconds{ 0.0 };
+    };
+}
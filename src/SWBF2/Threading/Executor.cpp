@@ -0,0 +1,76 @@
+
+#include <thread>
+#include <utility>
+
+#include "Executor.hpp"
+#include "GodotExecutor.hpp"
+#include "ThreadPool.hpp"
+
+namespace SWBF2
+{
+    namespace
+    {
+        thread_local TaskContext t_context;
+    }
+
+    std::mutex Executor::m_defaultMutex;
+    std::unique_ptr<Executor> Executor::m_default;
+
+    Executor &Executor::GetDefault()
+    {
+        std::lock_guard lock{ m_defaultMutex };
+
+        if (!m_default)
+        {
+            m_default = std::make_unique<ThreadPool>(std::thread::hardware_concurrency());
+        }
+
+        return *m_default;
+    }
+
+    void Executor::SetDefault(ExecutorBackend backend, std::size_t threadCount)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::thread::hardware_concurrency();
+        }
+
+        std::lock_guard lock{ m_defaultMutex };
+
+        m_default.reset();
+
+        switch (backend)
+        {
+            case ExecutorBackend::WorkerThreadPool:
+                m_default = std::make_unique<GodotExecutor>();
+                break;
+
+            case ExecutorBackend::ThreadPool:
+            default:
+                m_default = std::make_unique<ThreadPool>(threadCount);
+                break;
+        }
+    }
+
+    void Executor::Shutdown()
+    {
+        std::lock_guard lock{ m_defaultMutex };
+
+        m_default.reset();
+    }
+
+    const TaskContext &Executor::GetCurrentContext()
+    {
+        return t_context;
+    }
+
+    ScopedTaskContext::ScopedTaskContext(TaskContext context)
+        : m_previous(std::exchange(t_context, std::move(context)))
+    {
+    }
+
+    ScopedTaskContext::~ScopedTaskContext()
+    {
+        t_context = std::move(m_previous);
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include "../Types.hpp"
+
+#include "CancellationToken.hpp"
+
+namespace SWBF2
+{
+    class BatchIndex;
+
+    using Task = std::function<void()>;
+
+    enum class ExecutorBackend : uint32_t {
+        ThreadPool,       // our own work-stealing pool, for headless tools and benchmarks
+        WorkerThreadPool, // Godot's WorkerThreadPool, shared with the engine
+    };
+
+    enum class TaskPriority : uint32_t {
+        Blocking,   // someone waits on it right now
+        Visible,    // needed for what is about to be on screen
+        Background, // prefetch, runs once nothing else is queued
+
+        Count
+    };
+
+    // Priority and cancellation of the load a task belongs to. TaskGroup hands
+    // the submitting thread's context to its tasks, so subtasks inherit it.
+    typedef struct _TASK_CONTEXT
+    {
+        TaskPriority m_priority = TaskPriority::Visible;
+        CancellationToken m_token;
+        std::shared_ptr<BatchIndex> m_batchIndex; // only for files read by a load batch
+    } TaskContext;
+
+    // Runs the loader's parallel work. Every parallel part of the loader
+    // goes through the default executor, which can be swapped at runtime.
+    class Executor {
+    public:
+        virtual ~Executor() = default;
+
+        virtual void Submit(Task task, TaskPriority priority = TaskPriority::Visible) = 0;
+
+        // Runs one queued task on the calling thread, used by waiting threads
+        virtual bool RunPendingTask() = 0;
+
+        virtual std::size_t GetThreadCount() const = 0;
+        virtual ExecutorBackend GetBackend() const = 0;
+
+        static Executor &GetDefault();
+        static const TaskContext &GetCurrentContext();
+
+        // Must not be called while loads are in flight
+        static void SetDefault(ExecutorBackend backend, std::size_t threadCount = 0); // 0 means hardware concurrency
+        static void Shutdown();
+
+    private:
+        static std::mutex m_defaultMutex;
+        static std::unique_ptr<Executor> m_default;
+    };
+
+    // Sets the calling thread's task context until the end of the scope
+    class ScopedTaskContext {
+    public:
+        explicit ScopedTaskContext(TaskContext context);
+        ~ScopedTaskContext();
+
+        ScopedTaskContext(const ScopedTaskContext &) = delete;
+        ScopedTaskContext &operator=(const ScopedTaskContext &) = delete;
+
+    private:
+        TaskContext m_previous;
+    };
+}
@@ -0,0 +1,135 @@
+
+#include <algorithm>
+
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+
+#include "GodotExecutor.hpp"
+
+namespace SWBF2
+{
+    std::mutex GodotExecutor::m_instanceMutex;
+    GodotExecutor *GodotExecutor::m_instance = nullptr;
+
+    GodotExecutor::GodotExecutor()
+    {
+        std::lock_guard lock{ m_instanceMutex };
+        m_instance = this;
+    }
+
+    GodotExecutor::~GodotExecutor()
+    {
+        // every task queued in Godot has to run and be waited for before we go away
+        std::vector<int64_t> taskIds;
+        {
+            std::lock_guard lock{ m_mutex };
+            taskIds = std::move(m_taskIds);
+        }
+
+        auto *pool = godot::WorkerThreadPool::get_singleton();
+        for (auto id : taskIds)
+        {
+            pool->wait_for_task_completion(id);
+        }
+
+        std::lock_guard lock{ m_instanceMutex };
+        m_instance = nullptr;
+    }
+
+    void GodotExecutor::Submit(Task task, TaskPriority priority)
+    {
+        CollectFinishedTasks();
+
+        {
+            std::lock_guard lock{ m_mutex };
+            m_tasks[static_cast<std::size_t>(priority)].push_back(std::move(task));
+            ++m_submitted;
+        }
+
+        // Godot runs RunQueuedTask once per submitted task, it takes the most urgent task queued.
+        // Low priority tasks are capped to a fraction of the pool, which suits background loads only.
+        const bool highPriority = priority != TaskPriority::Background;
+        const auto id = godot::WorkerThreadPool::get_singleton()->add_task(callable_mp_static(&GodotExecutor::RunQueuedTask), highPriority, "SWBF2 load");
+
+        std::lock_guard lock{ m_mutex };
+        m_taskIds.push_back(id);
+    }
+
+    bool GodotExecutor::RunPendingTask()
+    {
+        Task task;
+        {
+            std::lock_guard lock{ m_mutex };
+
+            auto it = std::ranges::find_if(m_tasks, [](const auto &tasks) { return !tasks.empty(); });
+            if (it == m_tasks.end())
+            {
+                return false;
+            }
+
+            task = std::move(it->front());
+            it->pop_front();
+        }
+
+        task();
+        return true;
+    }
+
+    std::size_t GodotExecutor::GetThreadCount() const
+    {
+        // the pool size Godot uses, -1 or 0 means one thread per processor
+        const int64_t maxThreads = godot::ProjectSettings::get_singleton()->get_setting("threading/worker_pool/max_threads", -1);
+        if (maxThreads > 0)
+        {
+            return static_cast<std::size_t>(maxThreads);
+        }
+
+        return godot::OS::get_singleton()->get_processor_count();
+    }
+
+    ExecutorBackend GodotExecutor::GetBackend() const
+    {
+        return ExecutorBackend::WorkerThreadPool;
+    }
+
+    void GodotExecutor::RunQueuedTask()
+    {
+        std::unique_lock lock{ m_instanceMutex };
+        auto *instance = m_instance;
+        lock.unlock();
+
+        if (instance == nullptr)
+        {
+            return;
+        }
+
+        instance->RunPendingTask();
+        ++instance->m_finished;
+    }
+
+    void GodotExecutor::CollectFinishedTasks()
+    {
+        // Godot keeps a task until it is waited for. Checking ids one by one on every
+        // submit costs an engine call each, so only release them once all submitted
+        // tasks have run; then every wait returns at once and each id is waited once.
+        std::vector<int64_t> taskIds;
+        {
+            std::lock_guard lock{ m_mutex };
+            if (m_taskIds.empty() || m_finished != m_submitted)
+            {
+                return;
+            }
+
+            taskIds = std::move(m_taskIds);
+            m_taskIds.clear();
+        }
+
+        auto *pool = godot::WorkerThreadPool::get_singleton();
+        for (auto id : taskIds)
+        {
+            pool->wait_for_task_completion(id);
+        }
+    }
+}
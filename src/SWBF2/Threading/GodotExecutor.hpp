@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <deque>
+
+#include "Executor.hpp"
+
+namespace SWBF2
+{
+    // Runs tasks on Godot's WorkerThreadPool so loading shares the engine's
+    // threads instead of oversubscribing the cores.
+    class GodotExecutor : public Executor {
+    public:
+        GodotExecutor();
+        ~GodotExecutor() override;
+
+        void Submit(Task task, TaskPriority priority) override;
+        bool RunPendingTask() override;
+
+        std::size_t GetThreadCount() const override;
+        ExecutorBackend GetBackend() const override;
+
+    private:
+        static void RunQueuedTask();
+
+        void CollectFinishedTasks();
+
+        std::mutex m_mutex;
+        std::array<std::deque<Task>, static_cast<std::size_t>(TaskPriority::Count)> m_tasks;
+        std::vector<int64_t> m_taskIds;
+        std::size_t m_submitted = 0;
+        std::atomic<std::size_t> m_finished{ 0 };
+
+        static std::mutex m_instanceMutex;
+        static GodotExecutor *m_instance;
+    };
+}
@@ -0,0 +1,136 @@
+
+#include "LoadGraph.hpp"
+
+#include "../Logging.hpp"
+
+namespace SWBF2
+{
+    LoadGraph::LoadGraph(Executor &executor)
+        : m_executor(executor)
+    {
+    }
+
+    void LoadGraph::Add(LoadResource produces, LoadResource consumes, Task task)
+    {
+        const auto producesMask = static_cast<uint32_t>(produces);
+        const auto consumesMask = static_cast<uint32_t>(consumes);
+
+        // a node never waits for itself
+        m_nodes.push_back({ producesMask, consumesMask & ~producesMask, std::move(task) });
+    }
+
+    void LoadGraph::Run()
+    {
+        m_tasks = std::make_unique<TaskGroup>(m_executor);
+
+        std::vector<std::size_t> ready;
+
+        {
+            std::lock_guard lock{ m_mutex };
+
+            for (const auto &node : m_nodes)
+            {
+                for (auto bits = node.m_produces; bits != 0; bits &= bits - 1)
+                {
+                    ++m_producers[bits & (~bits + 1)];
+                }
+            }
+
+            uint32_t pending = 0;
+            for (const auto &[resource, count] : m_producers)
+            {
+                pending |= resource;
+            }
+
+            // nothing produces the resource, so it is as ready as it gets
+            m_ready = ~pending;
+
+            for (std::size_t i = 0; i < m_nodes.size(); ++i)
+            {
+                if ((m_nodes[i].m_consumes & ~m_ready) == 0)
+                {
+                    ready.push_back(i);
+                }
+                else
+                {
+                    m_waiting.push_back(i);
+                }
+            }
+        }
+
+        // submitted outside the lock, an executor may run the task inline
+        for (auto i : ready)
+        {
+            Submit(i);
+        }
+
+        m_tasks->Wait();
+
+        // only a dependency cycle leaves nodes behind, run them in order
+        if (!m_waiting.empty())
+        {
+            SWBF2_LOG(LogLevel::Error, __FILE__, ":", __LINE__, ": ", static_cast<int64_t>(m_waiting.size()), " load nodes in a dependency cycle, running them in order");
+
+            for (auto i : std::exchange(m_waiting, {}))
+            {
+                m_nodes[i].m_task();
+            }
+        }
+
+        m_nodes.clear();
+        m_producers.clear();
+        m_ready = 0;
+    }
+
+    void LoadGraph::Submit(std::size_t index)
+    {
+        m_tasks->Run([this, index]
+            {
+                struct Finish
+                {
+                    LoadGraph *m_graph;
+                    std::size_t m_index;
+                    ~Finish() { m_graph->OnFinished(m_index); }
+                } finish{ this, index };
+
+                m_nodes[index].m_task();
+            });
+    }
+
+    void LoadGraph::OnFinished(std::size_t index)
+    {
+        std::vector<std::size_t> ready;
+        std::unique_lock lock{ m_mutex };
+
+        for (auto bits = m_nodes[index].m_produces; bits != 0; bits &= bits - 1)
+        {
+            const auto resource = bits & (~bits + 1);
+            if (--m_producers[resource] == 0)
+            {
+                m_ready |= resource;
+            }
+        }
+
+        // publish: start every waiting node whose inputs are now all ready
+        auto it = m_waiting.begin();
+        while (it != m_waiting.end())
+        {
+            if ((m_nodes[*it].m_consumes & ~m_ready) == 0)
+            {
+                ready.push_back(*it);
+                it = m_waiting.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        lock.unlock();
+
+        for (auto i : ready)
+        {
+            Submit(i);
+        }
+    }
+}
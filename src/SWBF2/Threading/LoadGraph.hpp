@@ -0,0 +1,54 @@
+#pragma once
+
+#include "ThreadPool.hpp"
+
+namespace SWBF2
+{
+    // Resources chunk processors produce and consume, as bit flags. Only
+    // resources some processor produces are listed; a consumer is added here
+    // together with the code that reads the resource (world instances will
+    // need Models once wrld resolves its inst entries).
+    enum class LoadResource : uint32_t {
+        None = 0,
+        Models = 1u << 0,
+        World = 1u << 1,
+        EntityClasses = 1u << 2,
+    };
+
+    constexpr LoadResource operator|(LoadResource left, LoadResource right)
+    {
+        return static_cast<LoadResource>(static_cast<uint32_t>(left) | static_cast<uint32_t>(right));
+    }
+
+    typedef struct _LOAD_NODE
+    {
+        uint32_t m_produces;
+        uint32_t m_consumes;
+        Task m_task;
+    } LoadNode;
+
+    // Runs nodes on an executor. A node starts once every other node
+    // producing a resource it consumes has finished, ready nodes start in
+    // the order they were added.
+    class LoadGraph {
+    public:
+        explicit LoadGraph(Executor &executor = Executor::GetDefault());
+
+        void Add(LoadResource produces, LoadResource consumes, Task task);
+        void Run();
+
+    private:
+        void Submit(std::size_t index);
+        void OnFinished(std::size_t index);
+
+        Executor &m_executor;
+        std::unique_ptr<TaskGroup> m_tasks;
+
+        std::vector<LoadNode> m_nodes;
+        std::vector<std::size_t> m_waiting;
+        std::unordered_map<uint32_t, std::size_t> m_producers; // resource bit -> unfinished producers
+        uint32_t m_ready = 0;
+
+        std::mutex m_mutex;
+    };
+}
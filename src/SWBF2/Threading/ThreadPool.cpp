@@ -0,0 +1,237 @@
+
+#include "ThreadPool.hpp"
+
+namespace SWBF2
+{
+    namespace
+    {
+        thread_local const ThreadPool *t_pool = nullptr;
+        thread_local std::size_t t_queue = 0;
+    }
+
+    ThreadPool::ThreadPool(std::size_t threadCount)
+        : m_workerCount(std::max<std::size_t>(threadCount, 1)), m_threadCount(m_workerCount)
+    {
+        for (std::size_t i = 0; i < m_workerCount + static_cast<std::size_t>(TaskPriority::Count); ++i)
+        {
+            m_queues.push_back(std::make_unique<Queue>());
+        }
+
+        for (std::size_t i = 0; i < m_workerCount; ++i)
+        {
+            m_workers.emplace_back(&ThreadPool::WorkerMain, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock{ m_sleepMutex };
+            m_stop = true;
+        }
+
+        m_sleepCondition.notify_all();
+
+        for (auto &worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::Submit(Task task, TaskPriority priority)
+    {
+        // workers push to their own queue, other threads to the shared FIFO queue of the priority
+        const std::size_t index = t_pool == this ? t_queue : m_workerCount + static_cast<std::size_t>(priority);
+
+        // count before pushing so m_queued never drops below the number of queued tasks
+        {
+            std::lock_guard lock{ m_sleepMutex };
+            ++m_queued;
+        }
+
+        {
+            std::lock_guard lock{ m_queues[index]->m_mutex };
+            m_queues[index]->m_tasks.push_back(std::move(task));
+        }
+
+        m_sleepCondition.notify_one();
+    }
+
+    bool ThreadPool::RunPendingTask()
+    {
+        Task task;
+        if (!TryPop(t_pool == this ? t_queue : m_workerCount, task))
+        {
+            return false;
+        }
+
+        task();
+        return true;
+    }
+
+    std::size_t ThreadPool::GetThreadCount() const
+    {
+        return m_threadCount;
+    }
+
+    ExecutorBackend ThreadPool::GetBackend() const
+    {
+        return ExecutorBackend::ThreadPool;
+    }
+
+    void ThreadPool::WorkerMain(std::size_t index)
+    {
+        t_pool = this;
+        t_queue = index;
+
+        while (true)
+        {
+            Task task;
+            if (TryPop(index, task))
+            {
+                task();
+                continue;
+            }
+
+            std::unique_lock lock{ m_sleepMutex };
+            m_sleepCondition.wait(lock, [this] { return m_stop || m_queued > 0; });
+
+            if (m_stop)
+            {
+                return;
+            }
+        }
+    }
+
+    bool ThreadPool::TryPop(std::size_t index, Task &task)
+    {
+        if (m_queued == 0)
+        {
+            return false;
+        }
+
+        auto pop = [&](std::size_t queueIndex, bool newest)
+            {
+                auto &queue = *m_queues[queueIndex];
+                std::lock_guard lock{ queue.m_mutex };
+
+                if (queue.m_tasks.empty())
+                {
+                    return false;
+                }
+
+                if (newest)
+                {
+                    task = std::move(queue.m_tasks.back());
+                    queue.m_tasks.pop_back();
+                }
+                else
+                {
+                    task = std::move(queue.m_tasks.front());
+                    queue.m_tasks.pop_front();
+                }
+
+                --m_queued;
+                return true;
+            };
+
+        auto popShared = [&](TaskPriority priority)
+            {
+                return pop(m_workerCount + static_cast<std::size_t>(priority), false);
+            };
+
+        // index is m_workerCount for threads outside the pool, they have no own queue
+        if (popShared(TaskPriority::Blocking))
+        {
+            return true;
+        }
+
+        // own queue newest first, it holds subtasks of work this thread already started
+        if (index != m_workerCount && pop(index, true))
+        {
+            return true;
+        }
+
+        if (popShared(TaskPriority::Visible))
+        {
+            return true;
+        }
+
+        for (std::size_t i = 0; i < m_workerCount; ++i)
+        {
+            if (pop((index + 1 + i) % m_workerCount, false))
+            {
+                return true;
+            }
+        }
+
+        return popShared(TaskPriority::Background);
+    }
+
+    TaskGroup::TaskGroup(Executor &executor)
+        : m_executor(executor)
+    {
+    }
+
+    TaskGroup::~TaskGroup()
+    {
+        try
+        {
+            Wait();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void TaskGroup::Run(Task task)
+    {
+        ++m_pending;
+
+        const auto &context = Executor::GetCurrentContext();
+
+        m_executor.Submit([this, context, task = std::move(task)]
+            {
+                try
+                {
+                    ScopedTaskContext scope{ context };
+                    task();
+                }
+                catch (...)
+                {
+                    std::lock_guard lock{ m_mutex };
+                    if (!m_exception)
+                    {
+                        m_exception = std::current_exception();
+                    }
+                }
+
+                std::lock_guard lock{ m_mutex };
+                if (--m_pending == 0)
+                {
+                    m_condition.notify_all();
+                }
+            }, context.m_priority);
+    }
+
+    void TaskGroup::Wait()
+    {
+        while (m_pending > 0)
+        {
+            if (m_executor.RunPendingTask())
+            {
+                continue;
+            }
+
+            std::unique_lock lock{ m_mutex };
+            m_condition.wait_for(lock, std::chrono::milliseconds(1), [this] { return m_pending == 0; });
+        }
+
+        std::lock_guard lock{ m_mutex };
+        if (m_exception)
+        {
+            auto exception = std::exchange(m_exception, nullptr);
+            std::rethrow_exception(exception);
+        }
+    }
+}
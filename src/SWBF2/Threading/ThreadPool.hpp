@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "Executor.hpp"
+
+namespace SWBF2
+{
+    // Work-stealing pool. Tasks submitted from outside go to a shared FIFO
+    // queue per priority, tasks submitted by a worker go to its own queue.
+    // Workers take blocking tasks first, then their own queue newest first,
+    // then visible tasks, then steal the oldest task of another worker, and
+    // only then start background tasks. Threads waiting on a TaskGroup run
+    // queued tasks instead of blocking, so tasks may wait on subtasks.
+    class ThreadPool : public Executor {
+    public:
+        // Starts threadCount workers, at least one: loads are submitted and left
+        // to run, nobody may ever wait on them. A waiting thread helps on top.
+        explicit ThreadPool(std::size_t threadCount);
+        ~ThreadPool() override;
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        void Submit(Task task, TaskPriority priority) override;
+        bool RunPendingTask() override;
+
+        std::size_t GetThreadCount() const override;
+        ExecutorBackend GetBackend() const override;
+
+    private:
+        struct Queue
+        {
+            std::mutex m_mutex;
+            std::deque<Task> m_tasks;
+        };
+
+        void WorkerMain(std::size_t index);
+        bool TryPop(std::size_t index, Task &task);
+
+        std::vector<std::unique_ptr<Queue>> m_queues; // one per worker, then one shared queue per priority
+        std::size_t m_workerCount;
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_sleepMutex;
+        std::condition_variable m_sleepCondition;
+        std::atomic<std::size_t> m_queued{ 0 };
+        bool m_stop = false;
+
+        std::size_t m_threadCount;
+    };
+
+    // Tasks run on an executor and waited on together. The first exception thrown
+    // by a task is rethrown from Wait. Tasks run with the task context of the
+    // thread that called Run.
+    class TaskGroup {
+    public:
+        explicit TaskGroup(Executor &executor = Executor::GetDefault());
+        ~TaskGroup();
+
+        void Run(Task task);
+        void Wait();
+
+    private:
+        Executor &m_executor;
+
+        std::atomic<std::size_t> m_pending{ 0 };
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::exception_ptr m_exception;
+    };
+}
@@ -16,19 +16,19 @@ namespace SWBF2
             this->y = y;
         }
 
-        Vector2 operator+(T right) {
+        Vector2 operator+(T right) const {
             return Vector2(this->x + right, this->y + right);
         }
 
-        Vector2 operator-(T right) {
+        Vector2 operator-(T right) const {
             return Vector2(this->x - right, this->y - right);
         }
 
-        Vector2 operator*(T right) {
+        Vector2 operator*(T right) const {
             return Vector2(this->x * right, this->y * right);
         }
 
-        Vector2 operator/(T right) {
+        Vector2 operator/(T right) const {
             return Vector2(this->x / right, this->y / right);
         }
     };
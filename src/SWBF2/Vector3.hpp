@@ -17,35 +17,35 @@ namespace SWBF2
             this->z = z;
         }
 
-        Vector3 operator+(T right) {
+        Vector3 operator+(T right) const {
             return Vector3(this->x + right, this->y + right, this->z + right);
         }
 
-        Vector3 operator-(T right) {
+        Vector3 operator-(T right) const {
             return Vector3(this->x - right, this->y - right, this->z - right);
         }
 
-        Vector3 operator*(T right) {
+        Vector3 operator*(T right) const {
             return Vector3(this->x * right, this->y * right, this->z * right);
         }
 
-        Vector3 operator/(T right) {
+        Vector3 operator/(T right) const {
             return Vector3(this->x / right, this->y / right, this->z / right);
         }
 
-        Vector3 operator+(const Vector3 &right) {
+        Vector3 operator+(const Vector3 &right) const {
             return Vector3(this->x + right.x, this->y + right.y, this->z + right.z);
         }
 
-        Vector3 operator-(const Vector3 &right) {
+        Vector3 operator-(const Vector3 &right) const {
             return Vector3(this->x - right.x, this->y - right.y, this->z - right.z);
         }
 
-        Vector3 operator*(const Vector3 &right) {
+        Vector3 operator*(const Vector3 &right) const {
             return Vector3(this->x * right.x, this->y * right.y, this->z * right.z);
         }
 
-        Vector3 operator/(const Vector3 &right) {
+        Vector3 operator/(const Vector3 &right) const {
             return Vector3(this->x / right.x, this->y / right.y, this->z / right.z);
         }
     };